@@ -17,9 +17,11 @@
 ACCEL_BENCHMARKS
 
 #include <algorithm>
+#include <atomic>
 #include <list>
 #include <map>
 #include <numeric>
+#include <thread>
 #include <unordered_map>
 
 //================================================
@@ -47,6 +49,9 @@ BENCHMARK(Loop) {
     accel::retain(sum);
 }
 
+// The benchmarks in a group are compared against the first (baseline) benchmark.
+BENCHMARK_GROUP(Sum, Accumulate, Loop)
+
 //================================================
 // Parameterized
 //================================================
@@ -81,6 +86,9 @@ BENCHMARK_T(Emplace, template <class...> class C) {
 BENCHMARK_T_INSTANCE(Emplace, Map, std::map)
 BENCHMARK_T_INSTANCE(Emplace, UnorderedMap, std::unordered_map)
 
+// The instances of a parameterized or templated benchmark can be compared against one instance.
+BENCHMARK_BASELINE(Emplace, Map)
+
 //================================================
 // Paramaterized and Templated
 //================================================
@@ -98,6 +106,90 @@ BENCHMARK_PT_INSTANCE(Find, Vector10, ACCEL_GROUP(std::vector), 10)
 BENCHMARK_PT_INSTANCE(Find, Vector100, ACCEL_GROUP(std::vector), 100)
 BENCHMARK_PT_INSTANCE(Find, Vector1000, ACCEL_GROUP(std::vector), 1000)
 
+//================================================
+// Assertions
+//================================================
+
+BENCHMARK(Comparisons) {
+    uint64_t failures = 0;
+    for (auto integer : INTEGERS) {
+        failures += integer == 0;
+        failures += integer > INTEGERS.size();
+        failures += integer < 1;
+    }
+    accel::retain(failures);
+}
+
+// Assertions are usually made in the loops of tests, so a passing assertion should cost little
+// more than the comparison it makes.
+BENCHMARK(Assertions) {
+    accel::Failures _Accel_failures;
+    [&] {
+        for (auto integer : INTEGERS) {
+            EXPECT_NE(integer, 0u);
+            EXPECT_LE(integer, INTEGERS.size());
+            ASSERT_FALSE(integer < 1);
+        }
+    }();
+    accel::retain(_Accel_failures.size());
+}
+
+BENCHMARK_GROUP(Assert, Comparisons, Assertions)
+
+//================================================
+// Regions
+//================================================
+
+BENCHMARK(Pipeline) {
+    std::vector<uint64_t> integers;
+    {
+        REGION(generate);
+        integers = generate_integers(256);
+    }
+    {
+        REGION(transform);
+        auto square = [](auto integer) { return integer * integer; };
+        std::transform(integers.begin(), integers.end(), integers.begin(), square);
+    }
+    {
+        REGION(accumulate);
+        accel::retain(std::accumulate(integers.begin(), integers.end(), 0));
+    }
+}
+
+//================================================
+// Attributes
+//================================================
+
+// The attributes of a benchmark are set by a static member function of its fixture and are
+// overridden by the corresponding command-line options.
+struct Contended : public accel::Benchmark {
+    static std::atomic<uint64_t> counter;
+
+    static void configure(accel::Attributes& attributes) {
+        attributes.limit = std::chrono::seconds{1};
+        attributes.min_samples = 64;
+        attributes.threads = 4;
+    }
+};
+
+std::atomic<uint64_t> Contended::counter;
+
+BENCHMARK_F(Contended, Increment) {
+    counter.fetch_add(1);
+}
+
+struct Slow : public accel::Benchmark {
+    static void configure(accel::Attributes& attributes) {
+        attributes.warm_up = std::chrono::milliseconds{100};
+        attributes.disabled = true;
+    }
+};
+
+BENCHMARK_F(Slow, Sleep) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+}
+
 //================================================
 // Fixtures
 //================================================
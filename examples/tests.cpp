@@ -17,6 +17,11 @@
 ACCEL_TESTS
 
 #include <algorithm>
+#include <chrono>
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <limits>
 #include <list>
 #include <map>
 #include <numeric>
@@ -126,6 +131,21 @@ TEST_F(Integers, Test) {
     accel::retain(integers);
 }
 
+// The attributes of a test are set by a static member function of its fixture.
+struct Environment : public accel::Test {
+    // Tests which modify global state can require that they are not run concurrently with other
+    // tests when tests are run in parallel (`--jobs`).
+    static void configure(accel::TestAttributes& attributes) { attributes.serial = true; }
+};
+
+TEST_F(Environment, Locale) {
+    auto previous = std::setlocale(LC_ALL, nullptr);
+    std::string saved{previous ? previous : "C"};
+    auto changed = std::setlocale(LC_ALL, "C") != nullptr;
+    std::setlocale(LC_ALL, saved.c_str());
+    ASSERT_TRUE(changed);
+}
+
 //================================================
 // Assertions
 //================================================
@@ -213,6 +233,53 @@ TEST(FloatingPointComparison) {
     EXPECT_FPNE(3.14159f, 3.141581f, 10);
 }
 
+TEST(Range) {
+    std::vector<uint64_t> copy{INTEGERS};
+    EXPECT_RANGE_EQ(copy, INTEGERS);
+    EXPECT_SORTED(copy);
+    copy[10] = 0;
+    copy[500] = 0;
+    EXPECT_RANGE_EQ(copy, INTEGERS);
+    EXPECT_SORTED(copy);
+
+    auto positive = [](uint64_t integer) { return integer > 0; };
+    EXPECT_ALL_OF(INTEGERS, positive);
+    EXPECT_ALL_OF(accel::make_range(copy.data(), 100), positive);
+
+    std::vector<double> halves(8, 0.5);
+    EXPECT_RANGE_NEAR(halves, std::vector<double>(8, 0.45), 0.1);
+    EXPECT_RANGE_NEAR(halves, std::vector<double>(8, 0.45), 0.01);
+}
+
+TEST(FloatingPointRange) {
+    std::vector<float> expected(1000), actual(1000);
+    for (size_t index = 0; index < expected.size(); ++index) {
+        expected[index] = std::sin(0.01f * index);
+        actual[index] = std::nextafter(expected[index], 2.0f);
+    }
+    EXPECT_RANGE_FPEQ(actual, expected, 1);
+    EXPECT_RANGE_FPEQ(actual, expected, 0);
+
+    actual[7] = -actual[7];
+    actual[42] = std::numeric_limits<float>::quiet_NaN();
+    EXPECT_RANGE_FPNEAR(actual, expected, accel::FpTolerance{}.ulps(4).within(1e-6));
+
+    auto tolerance = accel::FpTolerance{}.near(1e-6);
+    EXPECT_RANGE_FPNEAR(accel::make_range(actual.data(), 7), expected, tolerance);
+}
+
+// Once a test has reported its maximum number of failures (`--max-failures`), further failures
+// are only counted and are not formatted.
+struct Limited : public accel::Test {
+    static void configure(accel::TestAttributes& attributes) { attributes.max_failures = 3; }
+};
+
+TEST_F(Limited, Capped) {
+    for (auto integer : INTEGERS) {
+        EXPECT(is_even, integer);
+    }
+}
+
 #if !defined(ACCEL_NO_EXCEPTIONS)
 TEST(Exception) {
     EXPECT_THROW(throw std::runtime_error{"Oh no!"});
@@ -223,3 +290,171 @@ TEST(Exception) {
     EXPECT_NOTHROW();
 }
 #endif
+
+// Performance assertions measure code with the benchmark engine and only fail when the 95%
+// confidence interval of the measurement lies entirely on the wrong side of the asserted bound.
+TEST(Performance) {
+    using namespace std::chrono_literals;
+    const auto& sorted = INTEGERS;
+    EXPECT_TIME_LT(std::binary_search(sorted.begin(), sorted.end(), 512u), 1us);
+
+    EXPECT_FASTER(std::binary_search(sorted.begin(), sorted.end(), 512u),
+        std::find(sorted.begin(), sorted.end(), 512u), 2.0);
+    EXPECT_FASTER(std::find(sorted.begin(), sorted.end(), 512u),
+        std::binary_search(sorted.begin(), sorted.end(), 512u), 2.0);
+
+    auto binary = [](uint64_t size) {
+        return [integers = generate_integers(size), size] {
+            return std::binary_search(integers.begin(), integers.end(), size / 2);
+        };
+    };
+    EXPECT_COMPLEXITY(binary, 1 << 8, 1 << 16, accel::Complexity::Logarithmic);
+
+    auto linear = [](uint64_t size) {
+        return [integers = generate_integers(size), size] {
+            return std::find(integers.begin(), integers.end(), size / 2);
+        };
+    };
+    EXPECT_COMPLEXITY(linear, 1 << 8, 1 << 16, accel::Complexity::Logarithmic);
+}
+
+// Allocation assertions count the heap allocations made by the statements they wrap and report
+// the call stack of the first allocation of a failing assertion (if the library is built with the
+// `count_allocations` option).
+TEST(Allocation) {
+    std::vector<uint64_t> integers;
+    integers.reserve(INTEGERS.size());
+    EXPECT_NO_ALLOCATIONS(integers.assign(INTEGERS.begin(), INTEGERS.end()));
+    EXPECT_MAX_ALLOCATIONS(1, std::vector<uint64_t> copy{INTEGERS}; accel::retain(copy));
+
+    EXPECT_NO_ALLOCATIONS(integers.push_back(0));
+    EXPECT_MAX_ALLOCATED(64, std::map<uint64_t, uint64_t> map; map[1] = 1; map[2] = 2);
+}
+
+//================================================
+// Properties
+//================================================
+
+// Property assertions check a predicate against values generated by typed generators, spreading
+// the cases over threads, and shrink counterexamples to minimal failing values.
+TEST(Property) {
+    auto reversible = [](const std::vector<int32_t>& values) {
+        auto copy = values;
+        std::reverse(copy.begin(), copy.end());
+        std::reverse(copy.begin(), copy.end());
+        return copy == values;
+    };
+    EXPECT_PROPERTY(reversible, accel::vectors(accel::integers<int32_t>()));
+
+    auto ordered = [](int32_t left, int32_t right) { return std::min(left, right) <= right; };
+    EXPECT_PROPERTY(ordered, accel::integers(-1000, 1000), accel::integers(-1000, 1000));
+
+    auto small = [](const std::vector<uint8_t>& values) {
+        return std::accumulate(values.begin(), values.end(), 0) < 100;
+    };
+    EXPECT_PROPERTY(small, accel::vectors(accel::integers<uint8_t>(0, 50)));
+
+    auto unpalindromic = [](const std::string& string) {
+        return string.size() < 2 || !std::equal(string.begin(), string.end(), string.rbegin());
+    };
+    EXPECT_PROPERTY(unpalindromic, accel::strings(0, 8, accel::characters("ab")));
+}
+
+// Generators of user types provide `generate` and `shrink` member functions.
+struct Fraction {
+    int64_t numerator;
+    int64_t denominator;
+
+    bool operator==(const Fraction& other) const {
+        return numerator == other.numerator && denominator == other.denominator;
+    }
+};
+
+std::ostream& operator<<(std::ostream& stream, const Fraction& fraction) {
+    return stream << fraction.numerator << "/" << fraction.denominator;
+}
+
+struct FractionGenerator {
+    using Value = Fraction;
+
+    accel::IntegerGenerator<int64_t> numerators = accel::integers<int64_t>();
+    accel::IntegerGenerator<int64_t> denominators = accel::integers<int64_t>(1, INT64_MAX);
+
+    void generate(accel::Random& random, uint64_t size, Fraction& fraction) const {
+        numerators.generate(random, size, fraction.numerator);
+        denominators.generate(random, size, fraction.denominator);
+    }
+
+    void shrink(const Fraction& fraction, std::vector<Fraction>& candidates) const {
+        std::vector<int64_t> integers;
+        numerators.shrink(fraction.numerator, integers);
+        for (auto numerator : integers) {
+            candidates.push_back({numerator, fraction.denominator});
+        }
+        integers.clear();
+        denominators.shrink(fraction.denominator, integers);
+        for (auto denominator : integers) {
+            candidates.push_back({fraction.numerator, denominator});
+        }
+    }
+};
+
+TEST(RoundTrip) {
+    auto serializable = [](const Fraction& fraction) {
+        char buffer[64];
+        std::snprintf(buffer, sizeof(buffer), "%lld/%lld",
+            static_cast<long long>(fraction.numerator),
+            static_cast<long long>(fraction.denominator));
+        Fraction parsed{0, 0};
+        long long numerator, denominator;
+        if (std::sscanf(buffer, "%lld/%lld", &numerator, &denominator) == 2) {
+            parsed = {numerator, denominator};
+        }
+        return parsed == fraction;
+    };
+    EXPECT_PROPERTY(serializable, FractionGenerator{});
+}
+
+//================================================
+// Fuzzing
+//================================================
+
+/// Parses a fraction with at most 18 digits in its numerator and denominator (e.g., `-3/4`).
+std::optional<Fraction> parse_fraction(const char* string, size_t size) {
+    auto end = string + size;
+    auto parse_digits = [&](int64_t& integer) {
+        auto start = string;
+        for (integer = 0; string != end && *string >= '0' && *string <= '9'; ++string) {
+            if (string - start == 18) {
+                return false;
+            }
+            integer = 10 * integer + (*string - '0');
+        }
+        return string != start;
+    };
+
+    auto negative = string != end && *string == '-';
+    string += negative ? 1 : 0;
+    Fraction fraction{0, 0};
+    if (!parse_digits(fraction.numerator) || string == end || *string++ != '/' ||
+        !parse_digits(fraction.denominator) || string != end || fraction.denominator == 0) {
+        return std::nullopt;
+    }
+    fraction.numerator = negative ? -fraction.numerator : fraction.numerator;
+    return fraction;
+}
+
+// Fuzz targets are run as tests which replay the inputs in `corpus/<name>` and are fuzzed with
+// `--fuzz=<name>`, which adds inputs that cover new code to the corpus when the fuzz targets are
+// compiled with `-fsanitize-coverage=trace-pc-guard`.
+FUZZ(ParseFraction, data, size) {
+    if (auto fraction = parse_fraction(reinterpret_cast<const char*>(data), size); fraction) {
+        char buffer[64];
+        auto length = std::snprintf(buffer, sizeof(buffer), "%lld/%lld",
+            static_cast<long long>(fraction->numerator),
+            static_cast<long long>(fraction->denominator));
+        auto reparsed = parse_fraction(buffer, static_cast<size_t>(length));
+        ASSERT_TRUE(reparsed.has_value());
+        ASSERT_EQ(*reparsed, *fraction);
+    }
+}
@@ -15,10 +15,23 @@
 #ifndef ACCEL_HPP
 #define ACCEL_HPP
 
+#include <accelerando/allocation.hpp>
 #include <accelerando/assert.hpp>
 #include <accelerando/benchmark.hpp>
+#include <accelerando/filter.hpp>
+#include <accelerando/fuzz.hpp>
+#include <accelerando/history.hpp>
 #include <accelerando/main.hpp>
+#include <accelerando/noise.hpp>
+#include <accelerando/performance.hpp>
+#include <accelerando/process.hpp>
+#include <accelerando/profiler.hpp>
+#include <accelerando/property.hpp>
+#include <accelerando/region.hpp>
 #include <accelerando/registry.hpp>
+#include <accelerando/state.hpp>
+#include <accelerando/statistics.hpp>
 #include <accelerando/test.hpp>
+#include <accelerando/threads.hpp>
 
 #endif
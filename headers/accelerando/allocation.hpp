@@ -0,0 +1,154 @@
+// Copyright 2017 Kyle Mayes
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCEL_ALLOCATION_HPP
+#define ACCEL_ALLOCATION_HPP
+
+#include <accelerando/assert.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace accel {
+
+/// The heap allocations made by a thread while they were counted.
+struct Allocations {
+    /// The maximum number of frames recorded for the call stack of the first allocation.
+    constexpr static size_t DEPTH = 32;
+
+    /// The number of allocations.
+    uint64_t count = 0;
+    /// The number of bytes allocated.
+    uint64_t bytes = 0;
+    /// The number of deallocations.
+    uint64_t deallocations = 0;
+    /// Whether the call stack of the first allocation is recorded.
+    bool trace = false;
+    /// The number of frames in the call stack of the first allocation.
+    size_t depth = 0;
+    /// The return addresses of the frames in the call stack of the first allocation (innermost
+    /// first).
+    void* frames[DEPTH] = {};
+
+    /// Returns the symbolized frames of the call stack of the first allocation which are outside
+    /// of the allocation functions (innermost first).
+    std::vector<std::string> get_trace() const;
+};
+
+/// Counts the heap allocations made by the calling thread while it is counting.
+///
+/// Allocations are counted by the global `operator new` and `operator delete`, which are replaced
+/// with functions that allocate with `malloc` and update the counter of the calling thread (if
+/// any). Counters may be nested, in which case the allocations counted by the innermost counter
+/// are also counted by the enclosing counters.
+///
+/// The allocation functions are only replaced if the library is built with
+/// `ACCEL_COUNT_ALLOCATIONS` defined (the `count_allocations` build option), since replacing them
+/// affects every allocation of the program linked with the library. Otherwise, no allocations are
+/// counted and the allocation assertions fail.
+class AllocationCounter {
+    Allocations allocations;
+    Allocations* previous;
+    bool counting = true;
+
+public:
+    /// Starts counting the allocations made by the calling thread and recording the call stack of
+    /// the first allocation (if requested).
+    explicit AllocationCounter(bool trace = false);
+
+    /// Stops counting the allocations made by the calling thread.
+    ~AllocationCounter();
+
+    AllocationCounter(const AllocationCounter&) = delete;
+    AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+    /// Stops counting the allocations made by the calling thread and returns them.
+    const Allocations& stop();
+
+    /// Returns whether allocations are counted (i.e., whether the library was built with
+    /// `ACCEL_COUNT_ALLOCATIONS` defined).
+    static bool is_enabled();
+};
+
+namespace detail {
+    /// The number of frames of the call stack of the first allocation added to failures.
+    constexpr static size_t ALLOCATION_FRAMES = 8;
+
+    /// Adds the call stack of the first of the supplied allocations to the supplied failure.
+    void add_trace(Failure& failure, const Allocations& allocations);
+
+    ASSERTION_T(allocations,
+    ACCEL_GROUP(class F), F function, uint64_t count, uint64_t bytes) {
+        if (!AllocationCounter::is_enabled()) {
+            return FAIL << "Allocations are not counted (build with ACCEL_COUNT_ALLOCATIONS)";
+        }
+
+        // The call stack of the first allocation is only recorded if it will be reported.
+        AllocationCounter counter{assertion.detailed};
+        function();
+        const auto& allocations = counter.stop();
+        if (allocations.count <= count && allocations.bytes <= bytes) {
+            return PASS;
+        } else {
+            auto failure = FAIL << "Exceeded the allocation limit";
+            failure.add_information("allocations", std::to_string(allocations.count));
+            failure.add_information("bytes", std::to_string(allocations.bytes));
+            failure.add_information("deallocations", std::to_string(allocations.deallocations));
+            add_trace(failure, allocations);
+            return failure;
+        }
+    }
+}
+
+//================================================
+// Allocation
+//================================================
+
+/// Defines an allocation assertion.
+#define ACCEL_ASSERT_ALLOCATIONS(RETURN, ASSERTION, COUNT, BYTES, ...) \
+    ACCEL_ASSERT_HELPER(RETURN, ASSERTION, \
+        ::accel::detail::allocations, ([&] { __VA_ARGS__; }), COUNT, BYTES)
+
+/// Defines a terminating assertion that some statements do not allocate.
+#define ASSERT_NO_ALLOCATIONS(...) \
+    ACCEL_ASSERT_ALLOCATIONS(true, "ASSERT_NO_ALLOCATIONS(" #__VA_ARGS__ ")", \
+        0, UINT64_MAX, __VA_ARGS__)
+/// Defines a non-terminating assertion that some statements do not allocate.
+#define EXPECT_NO_ALLOCATIONS(...) \
+    ACCEL_ASSERT_ALLOCATIONS(false, "EXPECT_NO_ALLOCATIONS(" #__VA_ARGS__ ")", \
+        0, UINT64_MAX, __VA_ARGS__)
+
+/// Defines a terminating assertion that some statements allocate at most a number of times.
+#define ASSERT_MAX_ALLOCATIONS(COUNT, ...) \
+    ACCEL_ASSERT_ALLOCATIONS(true, "ASSERT_MAX_ALLOCATIONS(" #COUNT ", " #__VA_ARGS__ ")", \
+        COUNT, UINT64_MAX, __VA_ARGS__)
+/// Defines a non-terminating assertion that some statements allocate at most a number of times.
+#define EXPECT_MAX_ALLOCATIONS(COUNT, ...) \
+    ACCEL_ASSERT_ALLOCATIONS(false, "EXPECT_MAX_ALLOCATIONS(" #COUNT ", " #__VA_ARGS__ ")", \
+        COUNT, UINT64_MAX, __VA_ARGS__)
+
+/// Defines a terminating assertion that some statements allocate at most a number of bytes.
+#define ASSERT_MAX_ALLOCATED(BYTES, ...) \
+    ACCEL_ASSERT_ALLOCATIONS(true, "ASSERT_MAX_ALLOCATED(" #BYTES ", " #__VA_ARGS__ ")", \
+        UINT64_MAX, BYTES, __VA_ARGS__)
+/// Defines a non-terminating assertion that some statements allocate at most a number of bytes.
+#define EXPECT_MAX_ALLOCATED(BYTES, ...) \
+    ACCEL_ASSERT_ALLOCATIONS(false, "EXPECT_MAX_ALLOCATED(" #BYTES ", " #__VA_ARGS__ ")", \
+        UINT64_MAX, BYTES, __VA_ARGS__)
+
+}
+
+#endif
@@ -18,13 +18,35 @@
 #include <accelerando/map.hpp>
 #include <accelerando/registry.hpp>
 
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <cstring>
 #include <functional>
 #include <iomanip>
+#include <iterator>
+#include <type_traits>
 
 namespace accel {
 
+#if defined(__GNUC__)
+    /// An attribute which inlines the calls in a function so that its loops can be vectorized.
+    #define ACCEL_FLATTEN [[gnu::flatten]]
+    /// An attribute which keeps a function which is only called by failed assertions out of line
+    /// and away from the code of passing assertions.
+    #define ACCEL_COLD [[gnu::cold, gnu::noinline]]
+    /// Expands to the supplied condition, hinted to be false.
+    #define ACCEL_UNLIKELY(CONDITION) __builtin_expect(static_cast<bool>(CONDITION), 0)
+#else
+    /// An attribute which inlines the calls in a function so that its loops can be vectorized.
+    #define ACCEL_FLATTEN
+    /// An attribute which keeps a function which is only called by failed assertions out of line
+    /// and away from the code of passing assertions.
+    #define ACCEL_COLD
+    /// Expands to the supplied condition, hinted to be false.
+    #define ACCEL_UNLIKELY(CONDITION) static_cast<bool>(CONDITION)
+#endif
+
 /// A collection of information about the assertion calling an assertion function.
 template <size_t SIZE>
 struct Assertion {
@@ -34,10 +56,13 @@ struct Assertion {
     const char* assertion;
     /// The string representations of the arguments supplied by the assertion.
     std::array<const char*, SIZE> arguments;
+    /// Whether a failure of the assertion will be reported (and so should be described).
+    bool detailed;
 
     /// Constructs a collection of information about an assertion.
-    Assertion(Location location, const char* assertion, std::array<const char*, SIZE> arguments)
-        : location{location}, assertion{assertion}, arguments{arguments} { }
+    Assertion(Location location, const char* assertion, std::array<const char*, SIZE> arguments,
+              bool detailed = true)
+        : location{location}, assertion{assertion}, arguments{arguments}, detailed{detailed} { }
 };
 
 /// Assists `ACCEL_SIZEOF`.
@@ -58,7 +83,7 @@ struct Assertion {
 /// Defines a templated assertion group function.
 #define ASSERTION_GROUP_T(FUNCTION, TYPES, ...) \
     template <TYPES> \
-    void FUNCTION(ACCEL_UNUSED std::vector<::accel::Failure>& _Accel_failures, __VA_ARGS__)
+    void FUNCTION(ACCEL_UNUSED ::accel::Failures& _Accel_failures, __VA_ARGS__)
 
 /// Defines an assertion group function.
 #define ASSERTION_GROUP(FUNCTION, ...) \
@@ -67,7 +92,10 @@ struct Assertion {
 /// Expands to a value which is returned by successful assertion functions.
 #define PASS (std::optional<::accel::Failure>{})
 /// Expands to a value which is returned by non-successful assertion functions.
-#define FAIL (::accel::Failure{assertion.location, assertion.assertion})
+///
+/// If the failure will not be reported (because the test has reached its failure limit), any
+/// message and information added to the failure are ignored without being formatted.
+#define FAIL (::accel::Failure{assertion.location, assertion.assertion, assertion.detailed})
 
 namespace detail {
     std::optional<std::string> stringify(bool value);
@@ -127,11 +155,42 @@ std::optional<std::string> stringify(const T& value) {
     return detail::stringify(value);
 }
 
+namespace detail {
+    /// Stores the failure returned by an assertion function, if any, and returns whether there
+    /// was a failure.
+    ACCEL_COLD inline bool record(Failures& failures, std::optional<Failure>&& failure) {
+        if (failure) {
+            failures.push_back(std::move(*failure));
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    /// Calls the supplied assertion function for an assertion whose condition was checked inline
+    /// and found to not hold and stores the failure it describes.
+    ///
+    /// The assertion function checks the condition again, so a failure is stored even if the
+    /// condition holds when checked again (e.g., if a comparison is inconsistent).
+    template <size_t SIZE, class F, class... T>
+    ACCEL_COLD void fail(
+        Failures& failures, const Assertion<SIZE>& assertion, F function, const T&... values
+    ) {
+        auto failure = function(assertion, values...);
+        if (!failure) {
+            failure = FAIL << "The condition did not hold but held when checked again";
+        }
+        failures.push_back(std::move(*failure));
+    }
+}
+
 /// Adds a key-value pair to the supplied assertion failure if the string representation of the
 /// supplied value differs from the supplied argument string representation.
 template <class T>
 void add_information(Failure& failure, const char* key, const T& value, const char* argument) {
-    if (auto string = stringify(value); string && *string != argument) {
+    if (!failure.detailed) {
+        return;
+    } else if (auto string = stringify(value); string && *string != argument) {
         failure.add_information(key, std::move(*string));
     }
 }
@@ -160,10 +219,57 @@ namespace detail {
         }
     }
 
+    /// The unsigned integer type with the same size as the supplied floating-point type.
+    template <class T>
+    using FloatBits = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+
+    /// Returns the bits of the supplied floating-point value mapped to an unsigned integer which
+    /// increases by one for each representable value from negative infinity to positive infinity.
+    ///
+    /// Negative values are stored as a sign and a magnitude, so they are mapped below the sign bit
+    /// by subtracting their magnitude from it (which also maps negative and positive zero to the
+    /// same integer). The mapping is computed without branches so that it can be vectorized.
+    template <class T>
+    FloatBits<T> get_ordered_bits(T value) {
+        using I = FloatBits<T>;
+        constexpr I SIGN = I{1} << (8 * sizeof(I) - 1);
+        I bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        I negative = I{0} - (bits >> (8 * sizeof(I) - 1));
+        I magnitude = bits & ~SIGN;
+        return SIGN + ((magnitude ^ negative) - negative);
+    }
+
+    /// Returns the difference in units in the last place for the supplied values which are not
+    /// NaN (without branches).
+    template <class T>
+    FloatBits<T> get_ordered_distance(T left, T right) {
+        auto l = get_ordered_bits(left);
+        auto r = get_ordered_bits(right);
+        return std::max(l, r) - std::min(l, r);
+    }
+
+    /// Returns the difference in units in the last place for the supplied values, or the largest
+    /// representable difference if either value is NaN.
+    template <class T>
+    FloatBits<T> get_ordered_difference(T left, T right) {
+        if (std::isnan(left) || std::isnan(right)) {
+            return ~FloatBits<T>{0};
+        } else {
+            return get_ordered_distance(left, right);
+        }
+    }
+
     /// Returns the difference in units in the last place for the supplied floats.
-    uint64_t get_ulp_difference(float left, float right);
+    inline uint64_t get_ulp_difference(float left, float right) {
+        auto difference = get_ordered_difference(left, right);
+        return difference == ~uint32_t{0} ? ~uint64_t{0} : difference;
+    }
+
     /// Returns the difference in units in the last place for the supplied doubles.
-    uint64_t get_ulp_difference(double left, double right);
+    inline uint64_t get_ulp_difference(double left, double right) {
+        return get_ordered_difference(left, right);
+    }
 
     ASSERTION_T(fpcmp,
     ACCEL_GROUP(class T,  class F), T left, T right, uint64_t ulp, F f) {
@@ -208,6 +314,375 @@ namespace detail {
 #endif
 }
 
+/// A contiguous range of values which can be supplied to range assertions.
+template <class T>
+struct Range {
+    /// The first value.
+    const T* pointer;
+    /// The number of values.
+    size_t length;
+
+    /// Returns the first value.
+    const T* data() const { return pointer; }
+    /// Returns the number of values.
+    size_t size() const { return length; }
+};
+
+/// Returns the contiguous range of values starting at the supplied pointer.
+template <class T>
+Range<T> make_range(const T* pointer, size_t length) {
+    return {pointer, length};
+}
+
+/// The tolerances of a floating-point range comparison.
+///
+/// A pair of values is equal if it is within any of the tolerances. NaNs are never equal.
+struct FpTolerance {
+    /// The largest difference in units in the last place.
+    uint64_t ulp = 0;
+    /// The largest difference relative to the larger magnitude of the values.
+    double relative = 0.0;
+    /// The largest absolute difference.
+    double absolute = 0.0;
+
+    /// Constructs a tolerance which only accepts identical values.
+    FpTolerance() = default;
+
+    /// Returns this tolerance with the supplied largest difference in units in the last place.
+    FpTolerance ulps(uint64_t ulp) const {
+        auto copy = *this;
+        copy.ulp = ulp;
+        return copy;
+    }
+    /// Returns this tolerance with the supplied largest relative difference.
+    FpTolerance within(double relative) const {
+        auto copy = *this;
+        copy.relative = relative;
+        return copy;
+    }
+    /// Returns this tolerance with the supplied largest absolute difference.
+    FpTolerance near(double absolute) const {
+        auto copy = *this;
+        copy.absolute = absolute;
+        return copy;
+    }
+};
+
+namespace detail {
+    /// The number of values range assertions check between searches for mismatches.
+    constexpr static size_t RANGE_BLOCK = 4096;
+    /// The number of mismatches reported by range assertions.
+    constexpr static size_t RANGE_REPORTED = 8;
+
+    /// The mismatches found in a range.
+    struct Mismatches {
+        /// The number of mismatches.
+        uint64_t count = 0;
+        /// The index of the first mismatch.
+        uint64_t first = 0;
+        /// The index of the last mismatch.
+        uint64_t last = 0;
+        /// The indices of the first mismatches (up to `RANGE_REPORTED`).
+        std::vector<uint64_t> indices;
+    };
+
+    /// Returns the mismatches among the indices in `[0, size)`.
+    ///
+    /// The number of mismatches in each block of indices is counted in a loop without branches
+    /// which the compiler can vectorize (the constant trip count of a full block lets it do so
+    /// without an epilogue, even under the cost model used at `-O2`). Only blocks which contain
+    /// mismatches are searched again to record where they are, so a range without mismatches is
+    /// checked in a single pass.
+    template <class F>
+    ACCEL_FLATTEN Mismatches find_mismatches(size_t size, F mismatch) {
+        Mismatches mismatches;
+        for (size_t start = 0; start < size; start += RANGE_BLOCK) {
+            auto end = std::min(size, start + RANGE_BLOCK);
+            size_t count = 0;
+            if (end - start == RANGE_BLOCK) {
+                for (size_t offset = 0; offset < RANGE_BLOCK; ++offset) {
+                    count += static_cast<size_t>(mismatch(start + offset));
+                }
+            } else {
+                for (auto index = start; index < end; ++index) {
+                    count += static_cast<size_t>(mismatch(index));
+                }
+            }
+            if (count == 0) {
+                continue;
+            }
+
+            for (auto index = start; index < end; ++index) {
+                if (mismatch(index)) {
+                    if (mismatches.indices.empty()) {
+                        mismatches.first = index;
+                    }
+                    mismatches.last = index;
+                    if (mismatches.indices.size() < RANGE_REPORTED) {
+                        mismatches.indices.push_back(index);
+                    }
+                }
+            }
+            mismatches.count += count;
+        }
+        return mismatches;
+    }
+
+    /// Adds the supplied mismatches in a range of the supplied size to the supplied failure using
+    /// the supplied function to format the values at the index of a mismatch.
+    template <class F>
+    void add_mismatches(Failure& failure, const Mismatches& mismatches, size_t size, F format) {
+        if (!failure.detailed) {
+            return;
+        }
+        failure.add_information("mismatches",
+            std::to_string(mismatches.count) + " of " + std::to_string(size));
+        failure.add_information("extent",
+            "[" + std::to_string(mismatches.first) + ", " + std::to_string(mismatches.last) + "]");
+        for (auto index : mismatches.indices) {
+            failure.add_information("[" + std::to_string(index) + "]", format(index));
+        }
+    }
+
+    /// Returns a string representation of the supplied value or `?` if there is none.
+    template <class T>
+    std::string describe(const T& value) {
+        return stringify(value).value_or("?");
+    }
+
+    /// Returns the type of the values in a range.
+    template <class R>
+    using RangeValue = std::remove_cv_t<std::remove_pointer_t<decltype(std::data(
+        std::declval<const R&>()))>>;
+
+    /// Returns whether values of the supplied type are equal if and only if their bytes are.
+    template <class T>
+    constexpr bool is_bitwise_comparable() {
+        return std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>;
+    }
+
+    ASSERTION_T(range_eq,
+    ACCEL_GROUP(class L, class R), const L& left, const R& right) {
+        auto l = std::data(left);
+        auto r = std::data(right);
+        size_t size = std::size(left);
+        if (size != std::size(right)) {
+            auto failure = FAIL << "Ranges differ in size";
+            failure.add_information("left size", std::to_string(size));
+            failure.add_information("right size", std::to_string(std::size(right)));
+            return failure;
+        }
+
+        using T = RangeValue<L>;
+        if constexpr (std::is_same_v<T, RangeValue<R>> && is_bitwise_comparable<T>()) {
+            if (size == 0 || std::memcmp(l, r, size * sizeof(T)) == 0) {
+                return PASS;
+            }
+        }
+
+        auto mismatches = find_mismatches(size, [&](size_t index) {
+            return !(l[index] == r[index]);
+        });
+        if (mismatches.count == 0) {
+            return PASS;
+        }
+
+        auto failure = FAIL;
+        add_mismatches(failure, mismatches, size, [&](size_t index) {
+            return describe(l[index]) + " != " + describe(r[index]);
+        });
+        return failure;
+    }
+
+    ASSERTION_T(range_near,
+    ACCEL_GROUP(class L, class R, class T), const L& left, const R& right, T tolerance) {
+        auto l = std::data(left);
+        auto r = std::data(right);
+        size_t size = std::size(left);
+        if (size != std::size(right)) {
+            auto failure = FAIL << "Ranges differ in size";
+            failure.add_information("left size", std::to_string(size));
+            failure.add_information("right size", std::to_string(std::size(right)));
+            return failure;
+        }
+
+        auto difference = [&](size_t index) {
+            return std::max(l[index], r[index]) - std::min(l[index], r[index]);
+        };
+        auto mismatches = find_mismatches(size, [&](size_t index) {
+            if constexpr (std::is_floating_point_v<RangeValue<L>>) {
+                // Both differences are checked (without short-circuiting) so that NaNs mismatch.
+                return !(l[index] - r[index] <= tolerance) | !(r[index] - l[index] <= tolerance);
+            } else {
+                return !(difference(index) <= tolerance);
+            }
+        });
+        if (mismatches.count == 0) {
+            return PASS;
+        }
+
+        auto failure = FAIL;
+        add_mismatches(failure, mismatches, size, [&](size_t index) {
+            return describe(l[index]) + " vs " + describe(r[index]) +
+                " (difference: " + describe(difference(index)) + ")";
+        });
+        return failure;
+    }
+
+    ASSERTION_T(all_of,
+    ACCEL_GROUP(class R, class P), const R& range, P predicate) {
+        auto values = std::data(range);
+        size_t size = std::size(range);
+        auto mismatches = find_mismatches(size, [&](size_t index) {
+            return !predicate(values[index]);
+        });
+        if (mismatches.count == 0) {
+            return PASS;
+        }
+
+        auto failure = FAIL;
+        add_mismatches(failure, mismatches, size, [&](size_t index) {
+            return describe(values[index]);
+        });
+        return failure;
+    }
+
+    ASSERTION_T(sorted,
+    ACCEL_GROUP(class R), const R& range) {
+        auto values = std::data(range);
+        size_t size = std::size(range);
+        auto pairs = size != 0 ? size - 1 : 0;
+        auto mismatches = find_mismatches(pairs, [&](size_t index) {
+            return values[index + 1] < values[index];
+        });
+        if (mismatches.count == 0) {
+            return PASS;
+        }
+
+        auto failure = FAIL;
+        add_mismatches(failure, mismatches, pairs, [&](size_t index) {
+            return describe(values[index]) + " > " + describe(values[index + 1]);
+        });
+        return failure;
+    }
+
+    /// Adds the statistics of the differences in units in the last place between the supplied
+    /// ranges, and the pairs of values with the largest differences, to the supplied failure.
+    template <class T>
+    void add_ulp_statistics(Failure& failure, const T* left, const T* right, size_t size) {
+        if (!failure.detailed) {
+            return;
+        }
+
+        // Bucket 0 counts equal values, bucket `n` counts differences in `[2^(n-1), 2^n)`, and the
+        // last bucket counts NaNs.
+        constexpr auto NAN_BUCKET = 8 * sizeof(T) + 1;
+        std::array<uint64_t, NAN_BUCKET + 1> histogram{};
+        std::vector<std::pair<uint64_t, size_t>> worst;
+        uint64_t largest = 0;
+        double sum = 0.0;
+        for (size_t index = 0; index < size; ++index) {
+            uint64_t difference = get_ordered_difference(left[index], right[index]);
+            if (difference == ~FloatBits<T>{0}) {
+                // NaNs are ranked above every difference.
+                histogram[NAN_BUCKET] += 1;
+                difference = ~uint64_t{0};
+            } else {
+                size_t bucket = 0;
+                for (auto remaining = difference; remaining != 0; remaining >>= 1) {
+                    bucket += 1;
+                }
+                histogram[bucket] += 1;
+                largest = std::max(largest, difference);
+                sum += difference;
+            }
+
+            // Keep the largest differences in a min-heap.
+            auto greater = std::greater<std::pair<uint64_t, size_t>>{};
+            if (worst.size() < RANGE_REPORTED) {
+                worst.emplace_back(difference, index);
+                std::push_heap(worst.begin(), worst.end(), greater);
+            } else if (difference > worst.front().first) {
+                std::pop_heap(worst.begin(), worst.end(), greater);
+                worst.back() = {difference, index};
+                std::push_heap(worst.begin(), worst.end(), greater);
+            }
+        }
+
+        auto numbers = size - histogram[NAN_BUCKET];
+        failure.add_information("max ulp", std::to_string(largest));
+        failure.add_information("mean ulp", *stringify(numbers != 0 ? sum / numbers : 0.0));
+
+        std::string buckets;
+        for (size_t bucket = 0; bucket < histogram.size(); ++bucket) {
+            if (histogram[bucket] == 0) {
+                continue;
+            } else if (!buckets.empty()) {
+                buckets.append(", ");
+            }
+            if (bucket == NAN_BUCKET) {
+                buckets.append("NaN");
+            } else if (bucket <= 1) {
+                buckets.append(std::to_string(bucket));
+            } else {
+                auto start = uint64_t{1} << (bucket - 1);
+                buckets.append(std::to_string(start) + "-" + std::to_string(2 * start - 1));
+            }
+            buckets.append(": " + std::to_string(histogram[bucket]));
+        }
+        failure.add_information("histogram", buckets);
+
+        std::sort(worst.begin(), worst.end(), [](const auto& l, const auto& r) {
+            return l.first != r.first ? l.first > r.first : l.second < r.second;
+        });
+        for (const auto& [difference, index] : worst) {
+            auto ulp = difference != ~uint64_t{0} ? std::to_string(difference) : "NaN";
+            failure.add_information("[" + std::to_string(index) + "]",
+                describe(left[index]) + " vs " + describe(right[index]) + " (ulp: " + ulp + ")");
+        }
+    }
+
+    ASSERTION_T(range_fpcmp,
+    ACCEL_GROUP(class L, class R), const L& left, const R& right, FpTolerance tolerance) {
+        using T = RangeValue<L>;
+        static_assert(std::is_same_v<T, RangeValue<R>> && std::is_floating_point_v<T>,
+            "floating-point range assertions require ranges of the same floating-point type");
+
+        auto l = std::data(left);
+        auto r = std::data(right);
+        size_t size = std::size(left);
+        if (size != std::size(right)) {
+            auto failure = FAIL << "Ranges differ in size";
+            failure.add_information("left size", std::to_string(size));
+            failure.add_information("right size", std::to_string(std::size(right)));
+            return failure;
+        }
+
+        // The tolerances are converted to the type of the values so the kernel stays in one width.
+        auto ulp = static_cast<FloatBits<T>>(std::min<uint64_t>(tolerance.ulp, ~FloatBits<T>{0}));
+        auto relative = static_cast<T>(tolerance.relative);
+        auto absolute = static_cast<T>(tolerance.absolute);
+        auto mismatches = find_mismatches(size, [&](size_t index) {
+            auto difference = std::abs(l[index] - r[index]);
+            auto scale = std::max(std::abs(l[index]), std::abs(r[index]));
+            auto nan = (l[index] != l[index]) | (r[index] != r[index]);
+            return nan | ((get_ordered_distance(l[index], r[index]) > ulp) &
+                !(difference <= absolute) & !(difference <= relative * scale));
+        });
+        if (mismatches.count == 0) {
+            return PASS;
+        }
+
+        auto failure = FAIL;
+        failure.add_information("mismatches",
+            std::to_string(mismatches.count) + " of " + std::to_string(size));
+        failure.add_information("extent",
+            "[" + std::to_string(mismatches.first) + ", " + std::to_string(mismatches.last) + "]");
+        add_ulp_statistics(failure, l, r, size);
+        return failure;
+    }
+}
+
 //================================================
 // Custom
 //================================================
@@ -220,15 +695,35 @@ namespace detail {
     constexpr auto SIZE = ACCEL_SIZEOF(__VA_ARGS__); \
     ::accel::Location location{__FILE__, __LINE__}; \
     std::array<const char*, SIZE> arguments{{ACCEL_MAP(ACCEL_STRINGIFY, __VA_ARGS__)}}; \
-    ::accel::Assertion<SIZE> assertion{location, ASSERTION, arguments}; \
-    if (auto failure = FUNCTION(assertion, __VA_ARGS__); failure) { \
-        _Accel_failures.push_back(std::move(*failure)); \
+    ::accel::Assertion<SIZE> assertion{ \
+        location, ASSERTION, arguments, _Accel_failures.is_accepting()}; \
+    if (auto failure = FUNCTION(assertion, __VA_ARGS__); ACCEL_UNLIKELY(failure)) { \
+        ::accel::detail::record(_Accel_failures, std::move(failure)); \
         if (RETURN) { \
             return; \
         } \
     } \
 }
 
+/// Assists the assertions whose condition is checked inline.
+///
+/// The supplied assertion function is only called (out of line) to describe the failure once the
+/// condition does not hold, so a passing assertion costs no more than its condition. The values
+/// are supplied to the assertion function and the arguments are their string representations.
+#define ACCEL_ASSERT_CHECK(RETURN, ASSERTION, CONDITION, FUNCTION, ARGUMENTS, ...) \
+    if (ACCEL_UNLIKELY(!(CONDITION))) { \
+        constexpr auto SIZE = ACCEL_SIZEOF(__VA_ARGS__); \
+        ::accel::Assertion<SIZE> assertion{::accel::Location{__FILE__, __LINE__}, ASSERTION, \
+            {{ACCEL_MAP(ACCEL_STRINGIFY, ARGUMENTS)}}, _Accel_failures.is_accepting()}; \
+        auto function = [](const auto& description, const auto&... values) { \
+            return FUNCTION(description, values...); \
+        }; \
+        ::accel::detail::fail(_Accel_failures, assertion, function, __VA_ARGS__); \
+        if (RETURN) { \
+            return; \
+        } \
+    }
+
 /// Defines a custom assertion.
 #define ACCEL_ASSERT(RETURN, NAME, FUNCTION, ...) \
     ACCEL_ASSERT_HELPER(RETURN, NAME "(" #FUNCTION ", " #__VA_ARGS__ ")", FUNCTION, __VA_ARGS__)
@@ -240,13 +735,10 @@ namespace detail {
 
 /// Defines a custom group assertion.
 #define ACCEL_ASSERT_GROUP(RETURN, FUNCTION, ...) { \
-    std::vector<::accel::Failure> failures; \
+    ::accel::Failures failures{_Accel_failures.get_remaining()}; \
     FUNCTION(failures, __VA_ARGS__); \
     auto failed = !failures.empty(); \
-    for (auto failure : failures) { \
-        failure.stack.insert(failure.stack.begin(), ::accel::Location{__FILE__, __LINE__}); \
-        _Accel_failures.push_back(std::move(failure)); \
-    } \
+    _Accel_failures.append(std::move(failures), ::accel::Location{__FILE__, __LINE__}); \
     if (failed && RETURN) { \
         return; \
     } \
@@ -262,9 +754,11 @@ namespace detail {
 //================================================
 
 /// Defines a boolean assertion.
-#define ACCEL_ASSERT_BOOLEAN(RETURN, NAME, VALUE, EXPECTED) \
-    ACCEL_ASSERT_HELPER(RETURN, NAME "(" #VALUE ")", \
-        ::accel::detail::boolean, VALUE, EXPECTED)
+#define ACCEL_ASSERT_BOOLEAN(RETURN, NAME, VALUE, EXPECTED) { \
+    const auto& _Accel_value = VALUE; \
+    ACCEL_ASSERT_CHECK(RETURN, NAME "(" #VALUE ")", _Accel_value == EXPECTED, \
+        ::accel::detail::boolean, ACCEL_GROUP(VALUE, EXPECTED), _Accel_value, EXPECTED) \
+}
 
 /// Defines a terminating truth assertion.
 #define ASSERT_TRUE(VALUE) ACCEL_ASSERT_BOOLEAN(true, "ASSERT_TRUE", VALUE, true)
@@ -281,9 +775,12 @@ namespace detail {
 //================================================
 
 /// Defines a comparison assertion.
-#define ACCEL_ASSERT_CMP(RETURN, NAME, LEFT, RIGHT, F) \
-    ACCEL_ASSERT_HELPER(RETURN, NAME "(" #LEFT ", " #RIGHT ")", \
-        ::accel::detail::cmp, LEFT, RIGHT, F{})
+#define ACCEL_ASSERT_CMP(RETURN, NAME, LEFT, RIGHT, F) { \
+    const auto& _Accel_left = LEFT; \
+    const auto& _Accel_right = RIGHT; \
+    ACCEL_ASSERT_CHECK(RETURN, NAME "(" #LEFT ", " #RIGHT ")", F{}(_Accel_left, _Accel_right), \
+        ::accel::detail::cmp, ACCEL_GROUP(LEFT, RIGHT, F{}), _Accel_left, _Accel_right, F{}) \
+}
 
 /// Defines a terminating equality assertion.
 #define ASSERT_EQ(LEFT, RIGHT) ACCEL_ASSERT_CMP(true, "ASSERT_EQ", LEFT, RIGHT, std::equal_to)
@@ -318,9 +815,15 @@ namespace detail {
 // Floating-point --------------------------------
 
 /// Defines a floating-point comparison assertion.
-#define ACCEL_ASSERT_FPCMP(RETURN, NAME, LEFT, RIGHT, ULP, F) \
-    ACCEL_ASSERT_HELPER(RETURN, NAME "(" #LEFT ", " #RIGHT "," #ULP ")", \
-        ::accel::detail::fpcmp, LEFT, RIGHT, ULP, F{})
+#define ACCEL_ASSERT_FPCMP(RETURN, NAME, LEFT, RIGHT, ULP, F) { \
+    const auto& _Accel_left = LEFT; \
+    const auto& _Accel_right = RIGHT; \
+    const uint64_t _Accel_ulp = ULP; \
+    ACCEL_ASSERT_CHECK(RETURN, NAME "(" #LEFT ", " #RIGHT "," #ULP ")", \
+        F{}(::accel::detail::get_ulp_difference(_Accel_left, _Accel_right), _Accel_ulp), \
+        ::accel::detail::fpcmp, ACCEL_GROUP(LEFT, RIGHT, ULP, F{}), \
+        _Accel_left, _Accel_right, _Accel_ulp, F{}) \
+}
 
 /// Defines a terminating floating-point equality assertion.
 #define ASSERT_FPEQ(LEFT, RIGHT, ULP) \
@@ -336,6 +839,76 @@ namespace detail {
 #define EXPECT_FPNE(LEFT, RIGHT, ULP) \
     ACCEL_ASSERT_FPCMP(false, "EXPECT_FPNE", LEFT, RIGHT, ULP, std::greater)
 
+//================================================
+// Range
+//================================================
+
+// Range assertions accept any contiguous ranges (e.g., `std::vector` or `accel::make_range`) and
+// report the number, extent, and first few of the mismatches in a single failure.
+
+/// Defines a range equality assertion.
+#define ACCEL_ASSERT_RANGE_EQ(RETURN, NAME, LEFT, RIGHT) \
+    ACCEL_ASSERT_HELPER(RETURN, NAME "(" #LEFT ", " #RIGHT ")", \
+        ::accel::detail::range_eq, LEFT, RIGHT)
+
+/// Defines a terminating range equality assertion.
+#define ASSERT_RANGE_EQ(LEFT, RIGHT) ACCEL_ASSERT_RANGE_EQ(true, "ASSERT_RANGE_EQ", LEFT, RIGHT)
+/// Defines a non-terminating range equality assertion.
+#define EXPECT_RANGE_EQ(LEFT, RIGHT) ACCEL_ASSERT_RANGE_EQ(false, "EXPECT_RANGE_EQ", LEFT, RIGHT)
+
+/// Defines a range tolerance assertion.
+#define ACCEL_ASSERT_RANGE_NEAR(RETURN, NAME, LEFT, RIGHT, TOLERANCE) \
+    ACCEL_ASSERT_HELPER(RETURN, NAME "(" #LEFT ", " #RIGHT ", " #TOLERANCE ")", \
+        ::accel::detail::range_near, LEFT, RIGHT, TOLERANCE)
+
+/// Defines a terminating range tolerance assertion.
+#define ASSERT_RANGE_NEAR(LEFT, RIGHT, TOLERANCE) \
+    ACCEL_ASSERT_RANGE_NEAR(true, "ASSERT_RANGE_NEAR", LEFT, RIGHT, TOLERANCE)
+/// Defines a non-terminating range tolerance assertion.
+#define EXPECT_RANGE_NEAR(LEFT, RIGHT, TOLERANCE) \
+    ACCEL_ASSERT_RANGE_NEAR(false, "EXPECT_RANGE_NEAR", LEFT, RIGHT, TOLERANCE)
+
+/// Defines a range predicate assertion.
+#define ACCEL_ASSERT_ALL_OF(RETURN, NAME, RANGE, PREDICATE) \
+    ACCEL_ASSERT_HELPER(RETURN, NAME "(" #RANGE ", " #PREDICATE ")", \
+        ::accel::detail::all_of, RANGE, PREDICATE)
+
+/// Defines a terminating range predicate assertion.
+#define ASSERT_ALL_OF(RANGE, PREDICATE) ACCEL_ASSERT_ALL_OF(true, "ASSERT_ALL_OF", RANGE, PREDICATE)
+/// Defines a non-terminating range predicate assertion.
+#define EXPECT_ALL_OF(RANGE, PREDICATE) \
+    ACCEL_ASSERT_ALL_OF(false, "EXPECT_ALL_OF", RANGE, PREDICATE)
+
+/// Defines a floating-point range comparison assertion.
+#define ACCEL_ASSERT_RANGE_FPCMP(RETURN, NAME, LEFT, RIGHT, TOLERANCE) \
+    ACCEL_ASSERT_HELPER(RETURN, NAME "(" #LEFT ", " #RIGHT ", " #TOLERANCE ")", \
+        ::accel::detail::range_fpcmp, LEFT, RIGHT, TOLERANCE)
+
+/// Defines a terminating floating-point range equality assertion.
+#define ASSERT_RANGE_FPEQ(LEFT, RIGHT, ULP) \
+    ACCEL_ASSERT_RANGE_FPCMP(true, "ASSERT_RANGE_FPEQ", LEFT, RIGHT, \
+        ::accel::FpTolerance{}.ulps(ULP))
+/// Defines a non-terminating floating-point range equality assertion.
+#define EXPECT_RANGE_FPEQ(LEFT, RIGHT, ULP) \
+    ACCEL_ASSERT_RANGE_FPCMP(false, "EXPECT_RANGE_FPEQ", LEFT, RIGHT, \
+        ::accel::FpTolerance{}.ulps(ULP))
+
+/// Defines a terminating floating-point range tolerance assertion.
+#define ASSERT_RANGE_FPNEAR(LEFT, RIGHT, TOLERANCE) \
+    ACCEL_ASSERT_RANGE_FPCMP(true, "ASSERT_RANGE_FPNEAR", LEFT, RIGHT, TOLERANCE)
+/// Defines a non-terminating floating-point range tolerance assertion.
+#define EXPECT_RANGE_FPNEAR(LEFT, RIGHT, TOLERANCE) \
+    ACCEL_ASSERT_RANGE_FPCMP(false, "EXPECT_RANGE_FPNEAR", LEFT, RIGHT, TOLERANCE)
+
+/// Defines a range order assertion.
+#define ACCEL_ASSERT_SORTED(RETURN, NAME, RANGE) \
+    ACCEL_ASSERT_HELPER(RETURN, NAME "(" #RANGE ")", ::accel::detail::sorted, RANGE)
+
+/// Defines a terminating range order assertion.
+#define ASSERT_SORTED(RANGE) ACCEL_ASSERT_SORTED(true, "ASSERT_SORTED", RANGE)
+/// Defines a non-terminating range order assertion.
+#define EXPECT_SORTED(RANGE) ACCEL_ASSERT_SORTED(false, "EXPECT_SORTED", RANGE)
+
 //================================================
 // Exception
 //================================================
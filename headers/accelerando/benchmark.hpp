@@ -15,62 +15,117 @@
 #ifndef ACCEL_BENCHMARK_HPP
 #define ACCEL_BENCHMARK_HPP
 
-#include <chrono>
-#include <cstdint>
+#include <accelerando/noise.hpp>
+#include <accelerando/region.hpp>
+#include <accelerando/statistics.hpp>
+
+#include <optional>
 #include <type_traits>
-#include <vector>
 
 namespace accel {
 
-/// An amount of time represented as a quantity of nanoseconds.
-template <class T>
-using Nanoseconds = std::chrono::duration<T, std::nano>;
-
-/// A sample taken by repeatedly executing a benchmark function.
-struct Sample {
-    /// The number of times the benchmark function was executed.
-    uint64_t iterations;
-    /// The total amount of time spent executing the benchmark function.
-    Nanoseconds<uint64_t> duration;
-    /// The average amount of time spent executing each iteration of the benchmark function.
-    Nanoseconds<double> average;
-
-    /// Constructs a benchmark sample.
-    Sample(uint64_t iterations, Nanoseconds<uint64_t> duration);
-};
-
-/// An ordinary least squares (OLS) linear regression.
-struct LinearRegression {
-    /// The y-intercept.
-    Nanoseconds<double> b0;
-    /// The slope.
-    Nanoseconds<double> b1;
-    /// The goodness of fit.
-    double r2;
-
-    /// Calculates and constructs an OLS linear regression.
-    LinearRegression(const std::vector<Sample>& samples);
-};
+class Profiler;
 
 /// A report generated by running a benchmark.
+///
+/// A report may be generated from the statistics accumulated by a benchmark at any time, so the
+/// memory required by a report does not depend on how long the benchmark ran.
 struct BenchmarkReport {
-    /// The samples collected.
-    std::vector<Sample> samples;
+    /// The statistics accumulated from the samples collected.
+    Statistics statistics;
     /// The average of the sample averages.
     Nanoseconds<double> mean;
     /// The standard deviation of the sample averages.
     Nanoseconds<double> stddev;
     /// The OLS linear regression calculated with the sample iterations as the explanatory variable
-    /// and the sample averages as the dependent variable.
+    /// and the sample durations as the dependent variable.
     LinearRegression ols;
+    /// The time spent in each named region of the benchmark function.
+    std::vector<RegionReport> regions;
 
     /// Constructs a benchmark report.
-    BenchmarkReport(std::vector<Sample> samples);
+    BenchmarkReport(Statistics statistics);
+    /// Constructs a benchmark report.
+    BenchmarkReport(const std::vector<Sample>& samples);
+};
+
+/// The clock used to time the samples collected by a benchmark.
+enum class Clock {
+    /// A monotonic wall clock.
+    Wall,
+    /// The CPU time consumed by the process.
+    Process,
+    /// The CPU time consumed by the calling thread.
+    Thread,
 };
 
+/// The configuration used to run a benchmark.
+struct BenchmarkConfig {
+    /// The amount of time to spend collecting samples.
+    Nanoseconds<uint64_t> limit{5'000'000'000};
+    /// The shortest targeted sample duration.
+    Nanoseconds<uint64_t> min_sample_time{1'000'000};
+    /// The longest targeted sample duration.
+    Nanoseconds<uint64_t> max_sample_time{10'000'000};
+    /// The profiler which samples the timed region of the benchmark, if any.
+    Profiler* profiler = nullptr;
+    /// How samples collected under changing CPU conditions are handled.
+    NoisePolicy noise = NoisePolicy::Keep;
+    /// The minimum number of samples to collect (even if the time limit is exceeded).
+    uint64_t min_samples = 0;
+    /// The maximum number of samples to collect.
+    uint64_t max_samples = UINT64_MAX;
+    /// The amount of time to spend executing the benchmark function before collecting samples.
+    Nanoseconds<uint64_t> warm_up{0};
+    /// The number of threads which concurrently execute the benchmark function in each sample.
+    uint64_t threads = 1;
+    /// The clock used to time the samples.
+    Clock clock = Clock::Wall;
+    /// The smallest relative change in the estimated time per iteration which matters (used to
+    /// decide how precise the estimate needs to be when a suite is run within a time budget).
+    double threshold = 0.05;
+
+    /// Constructs the default benchmark configuration.
+    BenchmarkConfig() = default;
+};
+
+/// The attributes of a benchmark which override the configuration it is run with.
+struct Attributes {
+    /// Overrides `BenchmarkConfig::limit`.
+    std::optional<Nanoseconds<uint64_t>> limit;
+    /// Overrides `BenchmarkConfig::min_samples`.
+    std::optional<uint64_t> min_samples;
+    /// Overrides `BenchmarkConfig::max_samples`.
+    std::optional<uint64_t> max_samples;
+    /// Overrides `BenchmarkConfig::warm_up`.
+    std::optional<Nanoseconds<uint64_t>> warm_up;
+    /// Overrides `BenchmarkConfig::threads`.
+    std::optional<uint64_t> threads;
+    /// Overrides `BenchmarkConfig::clock`.
+    std::optional<Clock> clock;
+    /// Overrides `BenchmarkConfig::threshold`.
+    std::optional<double> threshold;
+    /// Whether the benchmark is only run when disabled benchmarks are requested.
+    bool disabled = false;
+
+    /// Constructs empty benchmark attributes.
+    Attributes() = default;
+
+    /// Overrides the supplied configuration with the attributes which are set.
+    void apply(BenchmarkConfig& config) const;
+};
+
+class Registry;
+
 /// A benchmark.
 class Benchmark {
+    friend class Registry;
+
+    Attributes attributes;
+
 public:
+    /// Called to set the attributes of each instance of this benchmark.
+    static void configure(Attributes&) { }
     /// Called once before any instances of this benchmark are executed.
     static void static_set_up() { }
     /// Called once after all instances of this benchmark have been executed.
@@ -86,6 +141,11 @@ public:
     /// Called once after each instance of this benchmark is executed.
     virtual void tear_down() { }
 
+    /// Returns the attributes of this benchmark.
+    const Attributes& get_attributes() const { return attributes; }
+
+    /// Executes this benchmark with the supplied configuration and returns a report.
+    BenchmarkReport run(const BenchmarkConfig& config);
     /// Executes this benchmark for the supplied time limit and returns a report.
     BenchmarkReport run(Nanoseconds<uint64_t> limit);
 
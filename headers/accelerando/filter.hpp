@@ -0,0 +1,81 @@
+// Copyright 2017 Kyle Mayes
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef ACCEL_FILTER_HPP
+#define ACCEL_FILTER_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace accel {
+
+/// Returns whether the supplied name matches the supplied glob pattern.
+///
+/// In the pattern, `*` matches any sequence of characters and `?` matches any single character.
+bool match_glob(std::string_view pattern, std::string_view name);
+
+/// A glob pattern which has been split into its literal prefix and the remainder.
+struct Pattern {
+    /// How the remainder of a pattern is matched.
+    enum class Kind {
+        /// The pattern is a literal name.
+        Literal,
+        /// The pattern is a literal prefix followed by a single `*`.
+        Prefix,
+        /// The remainder of the pattern contains other wildcards.
+        Glob,
+    };
+
+    /// The pattern.
+    std::string glob;
+    /// The length of the literal prefix of the pattern.
+    size_t prefix;
+    /// How the remainder of the pattern is matched.
+    Kind kind;
+
+    /// Constructs a pattern.
+    explicit Pattern(std::string glob);
+
+    /// Returns whether the supplied name matches this pattern.
+    bool matches(std::string_view name) const;
+};
+
+/// Selects benchmark or test instances by matching their names against glob patterns.
+///
+/// A name is selected if it matches any of the included patterns (or if there are none) and does
+/// not match any of the excluded patterns.
+class Filter {
+    std::vector<Pattern> includes;
+    std::vector<Pattern> excludes;
+
+public:
+    /// Constructs a filter which selects every name.
+    Filter() = default;
+
+    /// Adds the supplied comma-separated patterns, where patterns prefixed with `-` are excluded.
+    void add(const std::string& patterns);
+
+    /// Returns whether the supplied name is selected.
+    bool matches(std::string_view name) const;
+
+    /// Returns the indices of the supplied names which are selected in ascending order.
+    std::vector<size_t> select(const std::vector<const char*>& names) const;
+};
+
+}
+
+#endif
@@ -0,0 +1,152 @@
+// Copyright 2017 Kyle Mayes
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCEL_FUZZ_HPP
+#define ACCEL_FUZZ_HPP
+
+#include <accelerando/property.hpp>
+#include <accelerando/registry.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace accel {
+
+/// The configuration used to replay and fuzz fuzz targets.
+struct FuzzConfig {
+    /// The directory which contains a directory of inputs for each fuzz target.
+    std::string corpus = "corpus";
+    /// The maximum length of the inputs generated (bytes).
+    uint64_t max_length = 4096;
+    /// The seed of the mutations.
+    uint64_t seed = 0x5EED;
+
+    /// Constructs the default fuzz configuration.
+    FuzzConfig() = default;
+};
+
+/// Returns the configuration used to replay and fuzz fuzz targets (which may be modified).
+FuzzConfig& get_fuzz_config();
+
+/// Returns whether any code was compiled with coverage instrumentation
+/// (`-fsanitize-coverage=trace-pc-guard` or `-fsanitize-coverage=trace-pc`).
+bool has_coverage();
+
+/// Returns the paths of the files in the supplied directory in lexicographical order.
+std::vector<std::string> list_corpus(const std::string& directory);
+
+/// A fuzz target.
+///
+/// When run as a test, a fuzz target executes each of the inputs in its corpus directory and fails
+/// if any input fails. Fuzz targets should not be compiled into the same object files as this
+/// library if coverage instrumentation is used since the fuzzer itself would then be measured.
+class Fuzz : public Test {
+public:
+    /// Returns the name of this fuzz target.
+    virtual const char* get_name() const = 0;
+    /// Returns the directory which contains the corpus of this fuzz target.
+    std::string get_directory() const;
+
+    /// The user-supplied fuzz target function.
+    virtual void fuzz(const uint8_t* data, size_t size, Failures& failures) = 0;
+
+protected:
+    virtual void execute(Failures& failures) override final;
+};
+
+/// The statistics of a fuzzing session.
+struct FuzzStats {
+    /// The number of inputs executed.
+    uint64_t execs = 0;
+    /// The number of inputs in the corpus.
+    uint64_t inputs = 0;
+    /// The number of inputs added to the corpus.
+    uint64_t added = 0;
+    /// The number of distinct features covered (pairs of an edge and a bucket of its hit count).
+    uint64_t features = 0;
+};
+
+/// An input which caused a fuzz target to fail.
+struct FuzzCrash {
+    /// The path the input was written to (or read from).
+    std::string path;
+    /// The report of the failed input.
+    TestReport report;
+};
+
+/// A coverage-guided mutation fuzzer which runs a fuzz target in-process.
+///
+/// The corpus is stored in a single buffer and each input is mutated in a reused buffer, so the
+/// only allocations in the mutation loop are those of the fuzz target itself and of any new inputs
+/// which are added to the corpus. An input is added to the corpus (and written to the corpus
+/// directory) if it covers a new edge or hits an edge a new number of times, using the hit count
+/// buckets of AFL (1, 2, 3, 4-7, 8-15, 16-31, 32-127, 128+).
+///
+/// While an input is executed, a crash signal causes the input to be written to the corpus
+/// directory before the signal is raised again.
+class Fuzzer {
+public:
+    /// Constructs a fuzzer for the supplied fuzz target.
+    Fuzzer(Fuzz& target, const FuzzConfig& config);
+
+    /// Executes the inputs in the corpus directory of the fuzz target and returns whether they all
+    /// passed.
+    bool load();
+    /// Executes up to the supplied number of mutated inputs and returns whether they all passed.
+    bool run(uint64_t execs);
+
+    /// Returns the statistics of this fuzzing session.
+    const FuzzStats& get_stats() const { return stats; }
+    /// Returns the input which failed, if any.
+    const std::optional<FuzzCrash>& get_crash() const { return crash; }
+
+private:
+    Fuzz& target;
+    FuzzConfig config;
+    std::string directory;
+    Random random;
+    FuzzStats stats;
+    std::vector<uint8_t> corpus;
+    std::vector<std::pair<size_t, size_t>> entries;
+    std::vector<uint8_t> buffer;
+    size_t length = 0;
+    std::vector<uint8_t> seen;
+    std::optional<FuzzCrash> crash;
+
+    void mutate();
+    bool execute(const uint8_t* data, size_t size, const std::string* path);
+    bool collect();
+    void keep(const uint8_t* data, size_t size, bool write);
+};
+
+/// Defines and registers a fuzz target which is supplied an input of `SIZE` bytes at `DATA`.
+#define FUZZ(NAME, DATA, SIZE) \
+    class ACCEL_CLASS(NAME) : public ::accel::Fuzz { \
+    public: \
+        virtual const char* get_name() const override final { return #NAME; } \
+        virtual void fuzz(const uint8_t* DATA, size_t SIZE, \
+                          ::accel::Failures& _Accel_failures) override final; \
+    }; \
+    auto ACCEL_UNIQUE = ::accel::Registry::get() \
+        .register_fuzz<ACCEL_CLASS(NAME)>(#NAME, ::accel::Location{__FILE__, __LINE__}); \
+    void ACCEL_CLASS(NAME)::fuzz(const uint8_t* DATA, size_t SIZE, \
+                                 ACCEL_UNUSED ::accel::Failures& _Accel_failures)
+
+}
+
+#endif
@@ -0,0 +1,115 @@
+// Copyright 2017 Kyle Mayes
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCEL_HISTORY_HPP
+#define ACCEL_HISTORY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace accel {
+
+/// Returns the 64-bit FNV-1a hash of the supplied string.
+uint64_t hash_string(const std::string& string);
+
+/// Returns a fingerprint of the host (its name, CPU model and number of CPUs).
+uint64_t get_host_fingerprint();
+
+/// Returns the revision of the code being benchmarked.
+///
+/// The revision is read from the `ACCEL_REVISION` environment variable or, if it is not set, from
+/// `git rev-parse` in the current directory.
+std::string get_revision();
+
+/// A benchmark result recorded in a history file.
+struct HistoryRecord {
+    /// The hash of the name of the benchmark.
+    uint64_t name;
+    /// The fingerprint of the host the benchmark was run on.
+    uint64_t host;
+    /// The time the benchmark was run (seconds since the UNIX epoch).
+    int64_t time;
+    /// The revision of the code benchmarked (truncated and NUL-padded).
+    char revision[16];
+    /// The estimated time per iteration of the benchmark function (nanoseconds).
+    double estimate;
+    /// The standard deviation of the sample averages (nanoseconds).
+    double stddev;
+    /// The number of samples collected.
+    uint64_t samples;
+};
+
+static_assert(sizeof(HistoryRecord) == 64, "history records must be 64 bytes");
+
+/// An append-only file of fixed-size benchmark results.
+///
+/// The file starts with a 16 byte header (a magic number, a version and the record size) followed
+/// by the records in the order they were appended. The records are memory-mapped when read.
+class History {
+public:
+    /// Opens the history file at the supplied path and maps the records it contains.
+    explicit History(std::string path);
+
+    ~History();
+
+    History(const History&) = delete;
+    History& operator=(const History&) = delete;
+
+    /// Returns whether the history file exists and is valid or does not exist.
+    bool is_valid() const { return valid; }
+
+    /// Appends the supplied record to the history file and returns whether it succeeded.
+    bool append(const HistoryRecord& record);
+
+    /// Returns the records which were in the history file when it was opened.
+    const HistoryRecord* begin() const { return records; }
+    /// Returns the records which were in the history file when it was opened.
+    const HistoryRecord* end() const { return records + size; }
+
+private:
+    std::string path;
+    bool valid = true;
+    const HistoryRecord* records = nullptr;
+    size_t size = 0;
+    void* mapping = nullptr;
+    size_t length = 0;
+    std::vector<HistoryRecord> buffer;
+};
+
+/// A step change in a series of values.
+struct Changepoint {
+    /// The index of the first value after the change.
+    size_t index;
+    /// The mean of the values in the segment before the change.
+    double before;
+    /// The mean of the values in the segment after the change.
+    double after;
+};
+
+/// Returns the step changes in the supplied series of positive values.
+///
+/// The changes are found by binary segmentation of the logarithms of the values. A segment is only
+/// split if doing so reduces the squared error by more than a penalty proportional to the noise in
+/// the series (estimated from the differences between consecutive values) and its length.
+std::vector<Changepoint> find_changepoints(const std::vector<double>& values);
+
+/// Returns the relative change per value of the least squares exponential fit to the supplied
+/// series of positive values (e.g., `0.01` if each value is 1% larger than the previous value).
+double calculate_drift(const std::vector<double>& values);
+
+}
+
+#endif
@@ -0,0 +1,93 @@
+// Copyright 2017 Kyle Mayes
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCEL_NOISE_HPP
+#define ACCEL_NOISE_HPP
+
+#include <accelerando/statistics.hpp>
+
+#include <cstdint>
+#include <string>
+
+namespace accel {
+
+/// How samples collected under changing CPU conditions are handled.
+enum class NoisePolicy {
+    /// The samples are accumulated unchanged.
+    Keep,
+    /// The samples are discarded.
+    Exclude,
+    /// The durations of the samples are scaled to the reference CPU frequency.
+    Normalize,
+};
+
+/// The CPU conditions observed while a sample was collected.
+struct Noise {
+    /// The effective frequency of the CPU (Hz) or zero if it could not be measured, which is the
+    /// number of cycles (in user and, where permitted, kernel mode) divided by the time the thread
+    /// was running.
+    double frequency = 0.0;
+    /// Whether the frequency of the CPU was observed to change during the sample.
+    bool changed = false;
+    /// The number of thermal throttling events.
+    uint64_t throttles = 0;
+    /// The number of migrations between CPUs.
+    uint64_t migrations = 0;
+
+    /// Returns whether the sample was affected by changing CPU conditions given the reference
+    /// frequency of the CPU (Hz) or zero if it is not known.
+    bool is_contaminated(double reference) const;
+};
+
+/// Observes the CPU conditions the samples of a benchmark are collected under.
+///
+/// The effective frequency is measured with a cycle counter (`perf_event_open`) over the time the
+/// thread was running where available and is otherwise read from `cpufreq` before and after each
+/// sample. Thermal throttling events are read from the `thermal_throttle` counters of the CPU and
+/// migrations are counted with a software counter or by comparing the CPUs the sample started and
+/// stopped on.
+class Monitor {
+public:
+    /// Constructs a monitor for the calling thread.
+    Monitor();
+
+    ~Monitor();
+
+    Monitor(const Monitor&) = delete;
+    Monitor& operator=(const Monitor&) = delete;
+
+    /// Starts observing the conditions of a sample.
+    void start();
+    /// Stops observing the conditions of a sample which lasted for the supplied amount of time.
+    Noise stop(Nanoseconds<uint64_t> duration);
+
+    /// Returns whether cycles can only be counted in user mode, in which case the frequency of
+    /// samples which spend time in system calls is understated.
+    bool is_restricted() const { return restricted; }
+
+private:
+    int cycles = -1;
+    bool restricted = false;
+    int migrations = -1;
+    int cpu = -1;
+    uint64_t cycles_start = 0;
+    uint64_t running_start = 0;
+    uint64_t migrations_start = 0;
+    uint64_t throttles_start = 0;
+    uint64_t frequency_start = 0;
+};
+
+}
+
+#endif
@@ -0,0 +1,286 @@
+// Copyright 2017 Kyle Mayes
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCEL_PERFORMANCE_HPP
+#define ACCEL_PERFORMANCE_HPP
+
+#include <accelerando/assert.hpp>
+#include <accelerando/benchmark.hpp>
+
+#include <chrono>
+#include <type_traits>
+
+namespace accel {
+
+/// The growth of the time taken by a function with the size of its input.
+enum class Complexity {
+    /// `O(1)`
+    Constant,
+    /// `O(log n)`
+    Logarithmic,
+    /// `O(n)`
+    Linear,
+    /// `O(n log n)`
+    Linearithmic,
+    /// `O(n²)`
+    Quadratic,
+    /// `O(n³)`
+    Cubic,
+};
+
+/// Returns the growth of the supplied complexity for an input of the supplied size.
+double get_growth(Complexity complexity, double size);
+/// Returns the name of the supplied complexity (e.g., `O(n log n)`).
+const char* get_name(Complexity complexity);
+
+/// The configuration used to measure functions in performance assertions.
+///
+/// A performance assertion measures in rounds until the 95% confidence interval of the measured
+/// quantity lies entirely on one side of the bound being asserted. If the interval still spans the
+/// bound after the last round the assertion passes, so a performance assertion only fails when it
+/// is violated with 95% confidence rather than whenever a noisy estimate crosses its bound.
+struct PerformanceConfig {
+    /// The amount of time spent measuring each function in each round.
+    Nanoseconds<uint64_t> limit{50'000'000};
+    /// The maximum number of rounds.
+    uint64_t rounds = 4;
+    /// The factor by which the growth of a function may exceed the growth of its asserted
+    /// complexity (allowing for cache effects at larger input sizes).
+    double tolerance = 1.5;
+
+    /// Constructs the default performance configuration.
+    PerformanceConfig() = default;
+
+    /// Returns the benchmark configuration used to measure each function in each round.
+    BenchmarkConfig get_benchmark_config() const;
+};
+
+/// Returns the configuration used to measure functions in performance assertions (which may be
+/// modified).
+PerformanceConfig& get_performance_config();
+
+namespace detail {
+    /// Executes the supplied function, retaining its result (if any).
+    template <class F>
+    void execute_retained(F& function) {
+        if constexpr (std::is_void_v<decltype(function())>) {
+            function();
+        } else {
+            retain(function());
+        }
+    }
+
+    /// A benchmark which executes a function.
+    template <class F>
+    class FunctionBenchmark : public Benchmark {
+        F& function;
+
+    public:
+        /// Constructs a benchmark which executes the supplied function.
+        explicit FunctionBenchmark(F& function) : function{function} { }
+
+    protected:
+        virtual void execute() override { execute_retained(function); }
+    };
+}
+
+/// The time per iteration of a function accumulated over one or more rounds of measurement.
+class Measurement {
+    Statistics statistics;
+
+public:
+    /// Constructs an empty measurement.
+    Measurement() = default;
+
+    /// Measures the supplied function for another round.
+    template <class F>
+    void extend(F& function, const PerformanceConfig& config) {
+        detail::FunctionBenchmark<F> benchmark{function};
+        statistics.merge(benchmark.run(config.get_benchmark_config()).statistics);
+    }
+
+    /// Returns the number of samples collected.
+    uint64_t get_samples() const { return statistics.count; }
+    /// Returns the OLS linear regression of the samples collected.
+    LinearRegression get_ols() const { return LinearRegression{statistics.regression}; }
+};
+
+namespace detail {
+    /// The position of a confidence interval relative to a bound.
+    enum class Side {
+        /// The interval lies entirely below the bound.
+        Below,
+        /// The interval lies entirely above the bound.
+        Above,
+        /// The interval contains the bound (or could not be calculated).
+        Across,
+    };
+
+    /// Returns the position of the supplied confidence interval relative to the supplied bound.
+    Side compare_interval(double lower, double upper, double bound);
+
+    /// Returns a string representation of the supplied ratio (e.g., `1.25×`).
+    std::string describe_ratio(double ratio);
+    /// Adds the time per iteration of the supplied measurement to the supplied failure.
+    void add_time(Failure& failure, const char* key, const Measurement& measurement);
+    /// Adds the supplied ratio and its confidence interval to the supplied failure.
+    void add_ratio(Failure& failure, const char* key, const Speedup& speedup);
+
+    ASSERTION_T(time_lt,
+    ACCEL_GROUP(class F, class D), F function, D budget) {
+        const auto config = get_performance_config();
+        auto bound = std::chrono::duration_cast<Nanoseconds<double>>(budget).count();
+        Measurement measurement;
+        auto side = Side::Across;
+        for (uint64_t round = 0; round < config.rounds && side == Side::Across; ++round) {
+            measurement.extend(function, config);
+            auto ols = measurement.get_ols();
+            side = compare_interval(ols.get_lower().count(), ols.get_upper().count(), bound);
+        }
+
+        if (side != Side::Above) {
+            return PASS;
+        } else {
+            auto failure = FAIL << "Exceeded the time budget";
+            add_time(failure, "time", measurement);
+            failure.add_information("samples", std::to_string(measurement.get_samples()));
+            return failure;
+        }
+    }
+
+    ASSERTION_T(faster,
+    ACCEL_GROUP(class F, class G), F fast, G slow, double factor) {
+        const auto config = get_performance_config();
+        Measurement left;
+        Measurement right;
+        auto side = Side::Across;
+        for (uint64_t round = 0; round < config.rounds && side == Side::Across; ++round) {
+            left.extend(fast, config);
+            right.extend(slow, config);
+            Speedup speedup{right.get_ols(), left.get_ols()};
+            side = compare_interval(speedup.lower, speedup.upper, factor);
+        }
+
+        if (side != Side::Below) {
+            return PASS;
+        } else {
+            auto failure = FAIL << "Not faster by the required factor";
+            add_time(failure, "left", left);
+            add_time(failure, "right", right);
+            add_ratio(failure, "speedup", Speedup{right.get_ols(), left.get_ols()});
+            return failure;
+        }
+    }
+
+    ASSERTION_T(complexity,
+    ACCEL_GROUP(class F), F factory, uint64_t small, uint64_t large, Complexity complexity) {
+        // The growth between the sizes is undefined if the growth at the smaller size is zero
+        // (e.g., `O(log n)` for a size of one).
+        auto small_growth = get_growth(complexity, static_cast<double>(small));
+        if (large <= small || !(small_growth > 0.0)) {
+            auto failure = FAIL << "Invalid input sizes for " << get_name(complexity);
+            failure.add_information("small", std::to_string(small));
+            failure.add_information("large", std::to_string(large));
+            return failure;
+        }
+
+        const auto config = get_performance_config();
+        auto bound = config.tolerance * get_growth(complexity, static_cast<double>(large)) /
+            small_growth;
+        auto small_function = factory(small);
+        auto large_function = factory(large);
+        Measurement smaller;
+        Measurement larger;
+        auto side = Side::Across;
+        for (uint64_t round = 0; round < config.rounds && side == Side::Across; ++round) {
+            smaller.extend(small_function, config);
+            larger.extend(large_function, config);
+            Speedup growth{larger.get_ols(), smaller.get_ols()};
+            side = compare_interval(growth.lower, growth.upper, bound);
+        }
+
+        if (side != Side::Above) {
+            return PASS;
+        } else {
+            auto failure = FAIL << "Grew faster than " << get_name(complexity);
+            add_time(failure, "small", smaller);
+            add_time(failure, "large", larger);
+            add_ratio(failure, "growth", Speedup{larger.get_ols(), smaller.get_ols()});
+            failure.add_information("bound", describe_ratio(bound));
+            return failure;
+        }
+    }
+}
+
+//================================================
+// Performance
+//================================================
+
+// Performance assertions measure code with the benchmark engine, so they should not be run
+// concurrently with other tests (e.g., with `--jobs`) if their budgets are tight.
+
+/// Defines a time per iteration assertion.
+#define ACCEL_ASSERT_TIME_LT(RETURN, NAME, EXPRESSION, BUDGET) \
+    ACCEL_ASSERT_HELPER(RETURN, NAME "(" #EXPRESSION ", " #BUDGET ")", \
+        ::accel::detail::time_lt, [&] { return EXPRESSION; }, BUDGET)
+
+/// Defines a terminating assertion that an expression takes less than a duration to evaluate.
+#define ASSERT_TIME_LT(EXPRESSION, BUDGET) \
+    ACCEL_ASSERT_TIME_LT(true, "ASSERT_TIME_LT", EXPRESSION, BUDGET)
+/// Defines a non-terminating assertion that an expression takes less than a duration to evaluate.
+#define EXPECT_TIME_LT(EXPRESSION, BUDGET) \
+    ACCEL_ASSERT_TIME_LT(false, "EXPECT_TIME_LT", EXPRESSION, BUDGET)
+
+/// Defines a relative speed assertion.
+#define ACCEL_ASSERT_FASTER(RETURN, NAME, FAST, SLOW, FACTOR) \
+    ACCEL_ASSERT_HELPER(RETURN, NAME "(" #FAST ", " #SLOW ", " #FACTOR ")", \
+        ::accel::detail::faster, [&] { return FAST; }, [&] { return SLOW; }, FACTOR)
+
+/// Defines a terminating assertion that an expression is evaluated at least a factor faster than
+/// another expression.
+#define ASSERT_FASTER(FAST, SLOW, FACTOR) \
+    ACCEL_ASSERT_FASTER(true, "ASSERT_FASTER", FAST, SLOW, FACTOR)
+/// Defines a non-terminating assertion that an expression is evaluated at least a factor faster
+/// than another expression.
+#define EXPECT_FASTER(FAST, SLOW, FACTOR) \
+    ACCEL_ASSERT_FASTER(false, "EXPECT_FASTER", FAST, SLOW, FACTOR)
+
+/// Defines a complexity assertion.
+#define ACCEL_ASSERT_COMPLEXITY(RETURN, NAME, FACTORY, SMALL, LARGE, COMPLEXITY) \
+    ACCEL_ASSERT_HELPER(RETURN, \
+        NAME "(" #FACTORY ", " #SMALL ", " #LARGE ", " #COMPLEXITY ")", \
+        ::accel::detail::complexity, FACTORY, SMALL, LARGE, COMPLEXITY)
+
+/// Defines a terminating assertion that the time taken by a function grows no faster than a
+/// complexity between two input sizes.
+///
+/// The factory is called with each input size and returns the function to measure. The larger
+/// size must exceed the smaller size and the complexity must grow at the smaller size (e.g., the
+/// smaller size must be at least two for `O(log n)` and `O(n log n)`), otherwise the assertion
+/// fails.
+#define ASSERT_COMPLEXITY(FACTORY, SMALL, LARGE, COMPLEXITY) \
+    ACCEL_ASSERT_COMPLEXITY(true, "ASSERT_COMPLEXITY", FACTORY, SMALL, LARGE, COMPLEXITY)
+/// Defines a non-terminating assertion that the time taken by a function grows no faster than a
+/// complexity between two input sizes.
+///
+/// The factory is called with each input size and returns the function to measure. The larger
+/// size must exceed the smaller size and the complexity must grow at the smaller size (e.g., the
+/// smaller size must be at least two for `O(log n)` and `O(n log n)`), otherwise the assertion
+/// fails.
+#define EXPECT_COMPLEXITY(FACTORY, SMALL, LARGE, COMPLEXITY) \
+    ACCEL_ASSERT_COMPLEXITY(false, "EXPECT_COMPLEXITY", FACTORY, SMALL, LARGE, COMPLEXITY)
+
+}
+
+#endif
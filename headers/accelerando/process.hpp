@@ -0,0 +1,173 @@
+// Copyright 2017 Kyle Mayes
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCEL_PROCESS_HPP
+#define ACCEL_PROCESS_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace accel {
+
+/// A compact binary encoding of values sent between processes.
+class Encoder {
+    std::string data;
+
+public:
+    /// Constructs an empty encoding.
+    Encoder() = default;
+
+    /// Appends the supplied trivially copyable value.
+    template <class T, std::enable_if_t<std::is_trivially_copyable_v<T>, int> = 0>
+    Encoder& write(T value) {
+        data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        return *this;
+    }
+
+    /// Appends the supplied string.
+    Encoder& write(const std::string& value) {
+        write<uint64_t>(value.size());
+        data.append(value);
+        return *this;
+    }
+
+    /// Returns the encoded values.
+    const std::string& get() const { return data; }
+};
+
+/// A decoder of the values in an encoding produced by `Encoder`.
+class Decoder {
+    const std::string& data;
+    size_t offset = 0;
+    bool valid = true;
+
+public:
+    /// Constructs a decoder of the supplied encoding.
+    explicit Decoder(const std::string& data) : data{data} { }
+
+    /// Returns the next trivially copyable value.
+    template <class T, std::enable_if_t<std::is_trivially_copyable_v<T>, int> = 0>
+    T read() {
+        T value{};
+        if (offset + sizeof(T) <= data.size()) {
+            std::memcpy(&value, data.data() + offset, sizeof(T));
+            offset += sizeof(T);
+        } else {
+            valid = false;
+        }
+        return value;
+    }
+
+    /// Returns the next string.
+    template <class T, std::enable_if_t<std::is_same_v<T, std::string>, int> = 0>
+    T read() {
+        auto size = read<uint64_t>();
+        if (valid && offset + size <= data.size()) {
+            offset += size;
+            return data.substr(offset - size, size);
+        } else {
+            valid = false;
+            return {};
+        }
+    }
+
+    /// Returns whether every value read so far was present in the encoding.
+    bool is_valid() const { return valid; }
+};
+
+/// The granularity at which workers are pinned to CPUs.
+enum class Pinning {
+    /// One worker for each logical CPU.
+    Cpu,
+    /// One worker for each physical core.
+    Core,
+    /// One worker for each last-level (L3) cache domain.
+    Cache,
+};
+
+/// Returns one CPU from each disjoint group of CPUs this process may run on at the supplied
+/// granularity, or an empty vector if the CPU topology is not available on this platform.
+std::vector<int> get_isolated_cpus(Pinning pinning);
+
+/// Restricts the calling process to the supplied CPU and returns whether it succeeded.
+bool pin_to_cpu(int cpu);
+
+/// Returns whether worker processes are supported on this platform.
+bool workers_supported();
+
+/// A pool of pre-forked worker processes which execute jobs sent by the parent process.
+///
+/// Jobs are identified by an index and executed by the handler in a worker process, which encodes
+/// the result of a job as a string that is sent back to the parent process over a pipe. A worker
+/// which exits while executing a job is replaced by a new worker.
+class Pool {
+public:
+    /// Executes the job with the supplied index in a worker process and returns the result.
+    using Handler = std::function<std::string(uint64_t)>;
+    /// Called in a worker process before it exits.
+    using Finish = std::function<void()>;
+    /// Called in the parent process with the result of a job or, if the worker executing the job
+    /// exited before returning a result, the signal which terminated the worker (if any).
+    using Done = std::function<void(uint64_t, std::optional<std::string>, int)>;
+    /// Returns the number of seconds the job with the supplied index may run for (or zero if the
+    /// job may run for any amount of time).
+    using Timeout = std::function<double(uint64_t)>;
+
+    /// The signal reported for a job whose worker was killed because the job exceeded its timeout.
+    constexpr static int TIMEOUT = -1;
+
+    /// Constructs a pool with a worker for each of the supplied CPUs (or the supplied number of
+    /// unpinned workers if no CPUs are supplied).
+    Pool(size_t workers, std::vector<int> cpus, Handler handler, Finish finish = {});
+
+    ~Pool();
+
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    /// Executes the supplied jobs and returns once every job has completed or timed out.
+    void run(const std::vector<uint64_t>& jobs, const Done& done, const Timeout& timeout = {});
+    /// Discards the jobs which have not been dispatched to a worker (jobs which are executing are
+    /// still completed).
+    void cancel();
+
+private:
+    struct Worker {
+        int pid = -1;
+        int input = -1;
+        int output = -1;
+        int cpu = -1;
+        std::optional<uint64_t> job;
+        std::optional<std::chrono::steady_clock::time_point> deadline;
+    };
+
+    std::vector<Worker> workers;
+    Handler handler;
+    Finish finish;
+    bool cancelled = false;
+
+    bool spawn(Worker& worker);
+    void shutdown(Worker& worker);
+    int reap(Worker& worker);
+};
+
+}
+
+#endif
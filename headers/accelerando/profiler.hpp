@@ -0,0 +1,93 @@
+// Copyright 2017 Kyle Mayes
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCEL_PROFILER_HPP
+#define ACCEL_PROFILER_HPP
+
+#include <accelerando/statistics.hpp>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace accel {
+
+/// An in-process sampling profiler.
+///
+/// While started, a CPU time interval timer interrupts the process and the call stack of the
+/// interrupted thread is written to a lock-free ring buffer by the signal handler. The signal may
+/// be delivered to any thread, so the handler may run on several threads at once. Call stacks are
+/// only recorded while the profiler is resumed, which allows samples to be attributed to a region
+/// of interest such as the timed loop of a benchmark. Only one profiler may be started at a time.
+class Profiler {
+public:
+    /// The maximum number of frames recorded for each call stack.
+    constexpr static size_t DEPTH = 64;
+
+    /// A call stack recorded by the signal handler.
+    struct Record {
+        /// One more than the position of this record in the ring buffer once it has been written
+        /// (or zero if it has not been written or has been consumed).
+        std::atomic<uint64_t> ready{0};
+        /// The number of frames in the call stack.
+        size_t depth;
+        /// The return addresses of the frames in the call stack (innermost first).
+        void* frames[DEPTH];
+    };
+
+    /// Constructs a profiler which samples at the supplied interval of CPU time.
+    Profiler(Nanoseconds<uint64_t> interval = Nanoseconds<uint64_t>{1'000'000});
+
+    ~Profiler();
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    /// Returns whether sampling profiling is supported on this platform.
+    static bool supported();
+
+    /// Starts the interval timer and returns whether the timer was started.
+    bool start();
+    /// Stops the interval timer.
+    void stop();
+
+    /// Starts recording call stacks.
+    void resume();
+    /// Stops recording call stacks and moves the call stacks recorded into the collected stacks.
+    void pause();
+
+    /// Returns the number of call stacks dropped because the ring buffer was full.
+    uint64_t get_dropped() const;
+
+    /// Returns the collected stacks in the folded format used by flame graph tools and clears
+    /// them. The frames of each stack are symbolized and ordered from outermost to innermost.
+    std::map<std::string, uint64_t> collect();
+
+private:
+    Nanoseconds<uint64_t> interval;
+    std::unique_ptr<Record[]> records;
+    std::map<std::vector<void*>, uint64_t> stacks;
+    bool started = false;
+};
+
+#if !defined(_WIN32)
+/// Returns a readable name for the function containing the supplied address.
+std::string symbolize(void* address);
+#endif
+
+}
+
+#endif
@@ -0,0 +1,441 @@
+// Copyright 2017 Kyle Mayes
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCEL_PROPERTY_HPP
+#define ACCEL_PROPERTY_HPP
+
+#include <accelerando/assert.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace accel {
+
+/// The configuration used to check properties.
+struct PropertyConfig {
+    /// The number of cases checked for each property.
+    uint64_t cases = 10'000;
+    /// The seed the seeds of the cases are derived from.
+    uint64_t seed = 0x5EED;
+    /// The number of threads which check cases (or zero for the number of hardware threads).
+    uint64_t threads = 0;
+    /// The size of the largest values generated (the sizes of the cases cycle up to this size).
+    uint64_t size = 100;
+    /// The maximum number of times a counterexample is shrunk.
+    uint64_t shrinks = 10'000;
+
+    /// Constructs the default property configuration.
+    PropertyConfig() = default;
+};
+
+/// Returns the configuration used to check properties (which may be modified).
+PropertyConfig& get_property_config();
+
+/// A pseudorandom number generator used to generate values (SplitMix64).
+///
+/// Each case of a property is generated by a generator seeded with a seed derived from the seed of
+/// the property and the index of the case, so a case can be reproduced without the cases before it
+/// and the cases checked do not depend on the number of threads which check them.
+class Random {
+    uint64_t state;
+
+public:
+    /// Constructs a pseudorandom number generator with the supplied seed.
+    explicit Random(uint64_t seed) : state{seed} { }
+
+    /// Returns the next pseudorandom integer.
+    uint64_t next() {
+        auto z = (state += 0x9E3779B97F4A7C15);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+        return z ^ (z >> 31);
+    }
+
+    /// Returns a pseudorandom integer less than the supplied bound (or any integer if the bound is
+    /// zero).
+    uint64_t below(uint64_t bound) {
+        if (bound == 0) {
+            return next();
+        }
+#if defined(__SIZEOF_INT128__)
+        // Lemire's multiply-shift reduction (the slight bias is irrelevant for generating cases).
+        __extension__ typedef unsigned __int128 Wide;
+        return static_cast<uint64_t>((static_cast<Wide>(next()) * bound) >> 64);
+#else
+        return next() % bound;
+#endif
+    }
+};
+
+// A generator of the values of type `T` supplied to properties is a type which provides:
+//
+//   using Value = T;
+//   void generate(Random& random, uint64_t size, T& value) const;
+//   void shrink(const T& value, std::vector<T>& candidates) const;
+//
+// `generate` overwrites a value (which may have been generated for a previous case, so containers
+// can reuse their storage) with a new value whose complexity is bounded by the size of the case.
+// `shrink` appends simpler variations of a value to the candidates (most aggressive first). The
+// member functions of a generator may be called concurrently.
+
+/// A generator of integers in a closed range.
+///
+/// Integers are drawn uniformly from the range, except that some are drawn from near the integer
+/// in the range closest to zero (bounded by the size of the case) or are the bounds of the range.
+/// Integers are shrunk towards the integer in the range closest to zero.
+template <class T>
+struct IntegerGenerator {
+    using Value = T;
+
+    /// The smallest integer generated.
+    T min;
+    /// The largest integer generated.
+    T max;
+
+    /// Returns the integer in the range closest to zero.
+    T get_origin() const {
+        return min > T{0} ? min : (max < T{0} ? max : T{0});
+    }
+
+    void generate(Random& random, uint64_t size, T& value) const {
+        auto bits = random.next();
+        auto width = static_cast<uint64_t>(max) - static_cast<uint64_t>(min);
+        if ((bits & 15) == 0) {
+            value = (bits & 16) != 0 ? min : max;
+        } else if ((bits & 3) == 0) {
+            auto origin = get_origin();
+            auto offset = random.below(size + 1);
+            if ((bits & 4) != 0 && origin > min) {
+                auto room = static_cast<uint64_t>(origin) - static_cast<uint64_t>(min);
+                value = static_cast<T>(static_cast<uint64_t>(origin) - std::min(offset, room));
+            } else {
+                auto room = static_cast<uint64_t>(max) - static_cast<uint64_t>(origin);
+                value = static_cast<T>(static_cast<uint64_t>(origin) + std::min(offset, room));
+            }
+        } else {
+            value = static_cast<T>(static_cast<uint64_t>(min) + random.below(width + 1));
+        }
+    }
+
+    void shrink(const T& value, std::vector<T>& candidates) const {
+        auto origin = get_origin();
+        if (value >= origin) {
+            auto distance = static_cast<uint64_t>(value) - static_cast<uint64_t>(origin);
+            for (auto step = distance; step != 0; step /= 2) {
+                candidates.push_back(static_cast<T>(static_cast<uint64_t>(value) - step));
+            }
+        } else {
+            auto distance = static_cast<uint64_t>(origin) - static_cast<uint64_t>(value);
+            for (auto step = distance; step != 0; step /= 2) {
+                candidates.push_back(static_cast<T>(static_cast<uint64_t>(value) + step));
+            }
+        }
+    }
+};
+
+/// A generator of booleans which shrinks `true` to `false`.
+struct BooleanGenerator {
+    using Value = bool;
+
+    void generate(Random& random, uint64_t, bool& value) const {
+        value = (random.next() & 1) != 0;
+    }
+
+    void shrink(bool value, std::vector<bool>& candidates) const {
+        if (value) {
+            candidates.push_back(false);
+        }
+    }
+};
+
+/// A generator of the characters in an alphabet which shrinks characters towards the first
+/// character in the alphabet.
+struct CharacterGenerator {
+    using Value = char;
+
+    /// The characters generated (which must outlive the generator).
+    std::string_view alphabet;
+
+    void generate(Random& random, uint64_t, char& value) const {
+        value = alphabet[random.below(alphabet.size())];
+    }
+
+    void shrink(char value, std::vector<char>& candidates) const {
+        auto index = alphabet.find(value);
+        if (index != 0 && index != std::string_view::npos) {
+            candidates.push_back(alphabet[0]);
+            if (index > 1) {
+                candidates.push_back(alphabet[index / 2]);
+            }
+        }
+    }
+};
+
+/// A generator of containers (e.g., `std::vector` or `std::string`) whose elements are generated
+/// by another generator.
+///
+/// The length of a container is bounded by the size of the case (and by the length bounds).
+/// Containers are shrunk by removing runs of elements and then by shrinking single elements.
+template <class C, class G>
+struct ContainerGenerator {
+    using Value = C;
+
+    /// The generator of the elements.
+    G element;
+    /// The smallest length generated.
+    size_t min_length;
+    /// The largest length generated.
+    size_t max_length;
+
+    void generate(Random& random, uint64_t size, C& value) const {
+        auto max = std::min<uint64_t>(max_length, std::max<uint64_t>(min_length, size));
+        value.resize(min_length + random.below(max - min_length + 1));
+        for (auto& item : value) {
+            element.generate(random, size, item);
+        }
+    }
+
+    void shrink(const C& value, std::vector<C>& candidates) const {
+        auto length = value.size();
+        for (auto run = length; run != 0; run /= 2) {
+            if (length - run < min_length) {
+                continue;
+            }
+            for (size_t start = 0; start + run <= length; start += run) {
+                auto& candidate = candidates.emplace_back(value);
+                candidate.erase(candidate.begin() + start, candidate.begin() + start + run);
+            }
+        }
+
+        std::vector<typename G::Value> items;
+        for (size_t index = 0; index < length; ++index) {
+            items.clear();
+            element.shrink(value[index], items);
+            for (const auto& item : items) {
+                candidates.emplace_back(value)[index] = item;
+            }
+        }
+    }
+};
+
+/// The printable ASCII characters.
+constexpr static std::string_view PRINTABLE =
+    "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"
+    " !\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~";
+
+/// Returns a generator of integers in the supplied closed range.
+template <class T>
+IntegerGenerator<T> integers(
+    T min = std::numeric_limits<T>::min(), T max = std::numeric_limits<T>::max()
+) {
+    return {min, max};
+}
+
+/// Returns a generator of booleans.
+inline BooleanGenerator booleans() {
+    return {};
+}
+
+/// Returns a generator of the characters in the supplied alphabet.
+inline CharacterGenerator characters(std::string_view alphabet = PRINTABLE) {
+    return {alphabet};
+}
+
+/// Returns a generator of vectors whose elements are generated by the supplied generator.
+template <class G>
+ContainerGenerator<std::vector<typename G::Value>, G> vectors(
+    G element, size_t min_length = 0, size_t max_length = SIZE_MAX
+) {
+    return {element, min_length, max_length};
+}
+
+/// Returns a generator of strings whose characters are generated by the supplied generator.
+inline ContainerGenerator<std::string, CharacterGenerator> strings(
+    size_t min_length = 0, size_t max_length = SIZE_MAX, CharacterGenerator element = characters()
+) {
+    return {element, min_length, max_length};
+}
+
+namespace detail {
+    /// Returns the seed of the case with the supplied index of a property with the supplied seed.
+    inline uint64_t get_case_seed(uint64_t seed, uint64_t index) {
+        Random random{seed ^ (index * 0xD1B54A32D192ED03)};
+        return random.next();
+    }
+
+    /// Searches for the first failing case of a property with the supplied number of threads.
+    ///
+    /// The cases are divided into chunks which are claimed in order by the threads and searched
+    /// with the supplied function, which returns the index of the first failing case in a range
+    /// or `UINT64_MAX`. Chunks after a failing case are not searched, so the first failing case is
+    /// found regardless of the number of threads.
+    uint64_t search_cases(
+        uint64_t cases, uint64_t threads, const std::function<uint64_t(uint64_t, uint64_t)>& search
+    );
+
+    /// Returns whether the supplied predicate holds for the supplied values (a predicate which
+    /// throws an exception does not hold).
+    template <class P, class... T>
+    bool holds(const P& predicate, const std::tuple<T...>& values) {
+#if defined(ACCEL_NO_EXCEPTIONS)
+        return std::apply(predicate, values);
+#else
+        try {
+            return std::apply(predicate, values);
+        } catch (...) {
+            return false;
+        }
+#endif
+    }
+
+    /// Generates the values of a case.
+    template <class... T, class... G, size_t... I>
+    void generate_values(
+        Random& random, uint64_t size, std::tuple<T...>& values, std::index_sequence<I...>,
+        const G&... generators
+    ) {
+        (generators.generate(random, size, std::get<I>(values)), ...);
+    }
+
+    /// Replaces a value of a counterexample with the first simpler value which still falsifies
+    /// the predicate and returns whether the value was replaced.
+    template <size_t I, class P, class... T, class G>
+    bool shrink_value(const P& predicate, std::tuple<T...>& values, const G& generator) {
+        std::vector<typename G::Value> candidates;
+        generator.shrink(std::get<I>(values), candidates);
+        for (size_t index = 0; index < candidates.size(); ++index) {
+            auto original = std::move(std::get<I>(values));
+            std::get<I>(values) = std::move(candidates[index]);
+            if (!holds(predicate, values)) {
+                return true;
+            }
+            std::get<I>(values) = std::move(original);
+        }
+        return false;
+    }
+
+    /// Shrinks a counterexample until none of its values can be shrunk (or the supplied limit is
+    /// reached) and returns the number of times it was shrunk.
+    template <class P, class... T, class... G, size_t... I>
+    uint64_t shrink_values(
+        const P& predicate, std::tuple<T...>& values, uint64_t limit, std::index_sequence<I...>,
+        const G&... generators
+    ) {
+        uint64_t shrinks = 0;
+        while (shrinks < limit && (shrink_value<I>(predicate, values, generators) || ...)) {
+            shrinks += 1;
+        }
+        return shrinks;
+    }
+
+    template <class T>
+    static auto test_range(int)
+        -> decltype(std::begin(std::declval<const T&>()), std::end(std::declval<const T&>()),
+            int());
+
+    template <class T>
+    static void test_range(bool);
+
+    /// Returns a string representation of the supplied value of a counterexample.
+    template <class T>
+    std::string describe_example(const T& value) {
+        if (auto string = stringify(value); string) {
+            return *string;
+        } else if constexpr (std::is_same_v<decltype(test_range<T>(0)), int>) {
+            std::string description{"["};
+            for (const auto& item : value) {
+                description.append(description.size() == 1 ? "" : ", ");
+                description.append(describe_example(item));
+            }
+            return description + "]";
+        } else {
+            return "?";
+        }
+    }
+
+    /// Checks that a predicate holds for the values generated by the supplied generators.
+    template <class P, class... G>
+    std::optional<Failure> check_property(
+        Assertion<1 + sizeof...(G)> assertion, P predicate, G... generators
+    ) {
+        const auto config = get_property_config();
+        using Values = std::tuple<typename G::Value...>;
+        auto sequence = std::index_sequence_for<G...>{};
+        auto generate = [&](uint64_t index, Values& values) {
+            Random random{get_case_seed(config.seed, index)};
+            generate_values(random, index % (config.size + 1), values, sequence, generators...);
+        };
+
+        auto search = [&](uint64_t start, uint64_t end) {
+            Values values;
+            for (auto index = start; index < end; ++index) {
+                generate(index, values);
+                if (!holds(predicate, values)) {
+                    return index;
+                }
+            }
+            return UINT64_MAX;
+        };
+        auto failing = search_cases(config.cases, config.threads, search);
+        if (failing == UINT64_MAX) {
+            return PASS;
+        }
+
+        auto failure = FAIL << "Falsified after " << (failing + 1) << " case(s)";
+        failure.add_information("seed", std::to_string(config.seed));
+        failure.add_information("case", std::to_string(failing));
+        if (failure.detailed) {
+            Values values;
+            generate(failing, values);
+            auto limit = config.shrinks;
+            auto shrinks = shrink_values(predicate, values, limit, sequence, generators...);
+            failure.add_information("shrinks", std::to_string(shrinks));
+            std::apply([&](const auto&... value) {
+                size_t index = 0;
+                (failure.add_information(sizeof...(G) == 1 ? std::string{"value"} :
+                    "value " + std::to_string(index++), describe_example(value)), ...);
+            }, values);
+        }
+        return failure;
+    }
+}
+
+//================================================
+// Property
+//================================================
+
+/// Defines a property assertion.
+#define ACCEL_ASSERT_PROPERTY(RETURN, NAME, PREDICATE, ...) \
+    ACCEL_ASSERT_HELPER(RETURN, NAME "(" #PREDICATE ", " #__VA_ARGS__ ")", \
+        ::accel::detail::check_property, PREDICATE, __VA_ARGS__)
+
+/// Defines a terminating assertion that a predicate holds for the values generated by some
+/// generators (which is shrunk to a minimal counterexample if it does not).
+#define ASSERT_PROPERTY(PREDICATE, ...) \
+    ACCEL_ASSERT_PROPERTY(true, "ASSERT_PROPERTY", PREDICATE, __VA_ARGS__)
+/// Defines a non-terminating assertion that a predicate holds for the values generated by some
+/// generators (which is shrunk to a minimal counterexample if it does not).
+#define EXPECT_PROPERTY(PREDICATE, ...) \
+    ACCEL_ASSERT_PROPERTY(false, "EXPECT_PROPERTY", PREDICATE, __VA_ARGS__)
+
+}
+
+#endif
@@ -0,0 +1,128 @@
+// Copyright 2017 Kyle Mayes
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCEL_REGION_HPP
+#define ACCEL_REGION_HPP
+
+#include <accelerando/statistics.hpp>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace accel {
+
+/// The maximum number of distinct region names (the last region collects any excess names).
+constexpr static size_t MAX_REGIONS = 64;
+
+/// The time spent in a named region of a benchmark function.
+struct RegionReport {
+    /// The name of the region.
+    std::string name;
+    /// The average amount of time spent in the region in each iteration of the benchmark function.
+    Nanoseconds<double> time;
+    /// The average number of times the region was entered in each iteration of the benchmark
+    /// function.
+    double calls;
+
+    /// Constructs a region report.
+    RegionReport(std::string name, Nanoseconds<double> time, double calls);
+};
+
+namespace detail {
+    /// The time and number of calls accumulated for a region by a thread.
+    ///
+    /// The counters are only incremented by the thread which owns them but are read and cleared by
+    /// the thread which runs the benchmark, so they are relaxed atomics. The owning thread
+    /// increments them with a load and a store rather than a read-modify-write since no other
+    /// thread increments them.
+    struct RegionSlot {
+        std::atomic<uint64_t> ticks;
+        std::atomic<uint64_t> calls;
+
+        /// Adds the supplied number of ticks and a call.
+        void add(uint64_t elapsed) {
+            ticks.store(ticks.load(std::memory_order_relaxed) + elapsed, std::memory_order_relaxed);
+            calls.store(calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    };
+
+    /// The time and number of calls accumulated for each region by the current thread.
+    inline thread_local RegionSlot REGION_SLOTS[MAX_REGIONS];
+    /// Whether the region slots of the current thread have been registered for collection.
+    inline thread_local bool REGION_REGISTERED = false;
+
+    /// Registers the region slots of the current thread for collection.
+    void register_region_slots();
+
+    /// Returns the current value of the timestamp counter or of a monotonic clock.
+    inline uint64_t get_ticks() {
+    #if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+    #else
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+    #endif
+    }
+
+    /// Clears the time and number of calls accumulated for each region by every thread.
+    void reset_regions();
+    /// Returns the time and number of calls accumulated for each region by every thread since the
+    /// last reset averaged over the supplied number of iterations of a benchmark function.
+    std::vector<RegionReport> collect_regions(uint64_t iterations);
+}
+
+/// A scoped marker which accumulates the time spent in a named region of a benchmark function.
+class Region {
+    size_t id;
+    uint64_t start;
+
+public:
+    /// Returns the identifier for the region with the supplied name.
+    static size_t get_id(const char* name);
+
+    /// Starts timing the region with the supplied identifier.
+    explicit Region(size_t id) : id{id}, start{detail::get_ticks()} { }
+
+    Region(const Region&) = delete;
+    Region& operator=(const Region&) = delete;
+
+    /// Stops timing the region.
+    ~Region() {
+        detail::REGION_SLOTS[id].add(detail::get_ticks() - start);
+        if (!detail::REGION_REGISTERED) {
+            detail::register_region_slots();
+        }
+    }
+};
+
+/// Assists `REGION`.
+#define ACCEL_REGION_HELPER(NAME, UNIQUE) \
+    static const auto _Accel_region_id_##UNIQUE = ::accel::Region::get_id(#NAME); \
+    ::accel::Region _Accel_region_##UNIQUE{_Accel_region_id_##UNIQUE}
+
+/// Assists `REGION`.
+#define ACCEL_REGION(NAME, UNIQUE) ACCEL_REGION_HELPER(NAME, UNIQUE)
+
+/// Times the remainder of the enclosing scope as the named region of a benchmark function.
+#define REGION(NAME) ACCEL_REGION(NAME, __COUNTER__)
+
+}
+
+#endif
@@ -19,6 +19,8 @@
 #include <accelerando/test.hpp>
 
 #include <memory>
+#include <type_traits>
+#include <utility>
 
 namespace accel {
 
@@ -38,25 +40,77 @@ struct Lifecycle {
     friend bool operator<(Lifecycle left, Lifecycle right);
 };
 
-/// A benchmark or test instance.
+/// A registered benchmark or test instance.
+///
+/// The benchmark or test itself is only constructed when the instance is run so that registering
+/// an instance is cheap and instances which are not selected never occupy any memory.
 template <class T>
 struct Instance {
+    /// The attributes of the benchmark or test (`Attributes` or `TestAttributes`).
+    using Attributes = std::decay_t<decltype(std::declval<const T&>().get_attributes())>;
+    /// A function which constructs the benchmark or test for an instance.
+    using Factory = std::unique_ptr<T> (*)(const Instance&);
+    /// A function which sets the attributes of the benchmark or test.
+    using Configure = void (*)(Attributes&);
+
     /// The static lifecycle functions.
     Lifecycle lifecycle;
     /// The user-supplied name.
-    std::string name;
-    /// The instance.
-    std::unique_ptr<T> instance;
+    const char* name;
+    /// The function which constructs the benchmark or test.
+    Factory factory;
+    /// The function which sets the attributes of the benchmark or test.
+    Configure configure;
+    /// The location the instance was defined at.
+    Location location;
+    /// The name of the parameterized or templated benchmark or test (or empty if none).
+    const char* family;
 
     /// Constructs an instance.
-    Instance(Lifecycle lifecycle, std::string name, std::unique_ptr<T> instance)
-        : lifecycle{lifecycle}, name{std::move(name)}, instance{std::move(instance)} { }
+    Instance(Lifecycle lifecycle, const char* name, Factory factory, Configure configure,
+             Location location, const char* family = "")
+        : lifecycle{lifecycle}
+        , name{name}
+        , factory{factory}
+        , configure{configure}
+        , location{location}
+        , family{family} { }
+
+    /// Returns the attributes of the benchmark or test.
+    Attributes get_attributes() const {
+        Attributes attributes;
+        configure(attributes);
+        return attributes;
+    }
+
+    /// Constructs the benchmark or test.
+    std::unique_ptr<T> create() const {
+        return factory(*this);
+    }
+};
+
+/// A group of benchmark instances compared against a baseline instance.
+struct Group {
+    /// The user-supplied name.
+    std::string name;
+    /// The name of the baseline instance.
+    std::string baseline;
+    /// The names of the other instances (empty if the group is a benchmark family).
+    std::vector<std::string> members;
+    /// Whether the members are the instances of the parameterized or templated benchmark with
+    /// the same name as the group.
+    bool family = false;
+
+    /// Returns whether the benchmark instance with the supplied name and family is a member.
+    bool contains(const std::string& instance, const std::string& family) const;
 };
 
 /// A collection of registered benchmarks or tests.
 class Registry {
     std::vector<Instance<Benchmark>> benchmarks;
     std::vector<Instance<Test>> tests;
+    std::vector<const char*> fuzz_targets;
+    std::vector<Group> groups;
 
 public:
     /// Returns the registry.
@@ -64,28 +118,61 @@ public:
 
     /// Registers the benchmark provided as a type parameter under the supplied name.
     template <class T>
-    int register_benchmark(const char* name) {
+    int register_benchmark(const char* name, const char* family, Location location) {
         Lifecycle lifecycle{&T::static_set_up, &T::static_tear_down};
-        benchmarks.emplace_back(lifecycle, name, std::make_unique<T>());
+        benchmarks.emplace_back(
+            lifecycle, name, &create_benchmark<T>, &T::configure, location, family);
         return 0;
     }
 
+    /// Registers a group of benchmarks under the supplied name.
+    ///
+    /// The members are supplied as a comma-separated list of names or, if null, are the instances
+    /// of the parameterized or templated benchmark with the same name as the group.
+    int register_group(const char* name, const char* baseline, const char* members);
+
     /// Registers the test provided as a type parameter under the supplied name.
     template <class T>
     int register_test(const char* name, Location location) {
         Lifecycle lifecycle{&T::static_set_up, &T::static_tear_down};
-        tests.emplace_back(lifecycle, name, std::make_unique<T>());
-        tests.back().instance->location = location;
+        tests.emplace_back(lifecycle, name, &create_test<T>, &T::configure, location);
         return 0;
     }
 
+    /// Registers the fuzz target provided as a type parameter (a subclass of `Fuzz`) under the
+    /// supplied name as a test which replays the corpus of the fuzz target.
+    template <class T>
+    int register_fuzz(const char* name, Location location) {
+        fuzz_targets.push_back(name);
+        return register_test<T>(name, location);
+    }
+
     /// Returns the registered benchmarks.
     const std::vector<Instance<Benchmark>>& get_benchmarks() const;
     /// Returns the registered tests.
     const std::vector<Instance<Test>>& get_tests() const;
+    /// Returns the names of the registered tests which are fuzz targets.
+    const std::vector<const char*>& get_fuzz_targets() const;
+    /// Returns the registered benchmark groups.
+    const std::vector<Group>& get_groups() const;
 
 private:
     Registry() = default;
+
+    template <class T>
+    static std::unique_ptr<Benchmark> create_benchmark(const Instance<Benchmark>& instance) {
+        auto benchmark = std::make_unique<T>();
+        benchmark->attributes = instance.get_attributes();
+        return benchmark;
+    }
+
+    template <class T>
+    static std::unique_ptr<Test> create_test(const Instance<Test>& instance) {
+        auto test = std::make_unique<T>();
+        test->location = instance.location;
+        test->attributes = instance.get_attributes();
+        return test;
+    }
 };
 
 /// Assists `ACCEL_CLASS`.
@@ -116,19 +203,19 @@ private:
 // Benchmarks
 //================================================
 
-/// Implements `BENCHMARK_F`.
-#define ACCEL_BENCHMARK_F(FIXTURE, NAME) \
+/// Implements `BENCHMARK_F` and `BENCHMARK_PT_INSTANCE`.
+#define ACCEL_BENCHMARK_F(FIXTURE, NAME, FAMILY) \
     class ACCEL_CLASS(NAME) : public FIXTURE { \
     protected: \
         virtual void execute() override final; \
     }; \
-    auto ACCEL_UNIQUE = ::accel::Registry::get() \
-        .register_benchmark<ACCEL_CLASS(NAME)>(#NAME); \
+    auto ACCEL_UNIQUE = ::accel::Registry::get().register_benchmark<ACCEL_CLASS(NAME)>( \
+        #NAME, FAMILY, ::accel::Location{__FILE__, __LINE__}); \
     void ACCEL_CLASS(NAME)::execute()
 
 /// Defines and registers a benchmark.
 #define BENCHMARK_F(FIXTURE, NAME) \
-    ACCEL_BENCHMARK_F(FIXTURE, NAME)
+    ACCEL_BENCHMARK_F(FIXTURE, NAME, "")
 
 /// Defines and registers a benchmark.
 #define BENCHMARK(NAME) \
@@ -150,7 +237,7 @@ private:
 
 /// Defines and registers an instance of a parameterized and templated benchmark.
 #define BENCHMARK_PT_INSTANCE(NAME, SUBNAME, TYPES, ...) \
-    ACCEL_BENCHMARK_F(ACCEL_CLASS(NAME), NAME##_##SUBNAME) { \
+    ACCEL_BENCHMARK_F(ACCEL_CLASS(NAME), NAME##_##SUBNAME, #NAME) { \
         execute_pt<TYPES>(__VA_ARGS__); \
     }
 
@@ -178,6 +265,17 @@ private:
 #define BENCHMARK_T_INSTANCE(NAME, SUBNAME, ...) \
     BENCHMARK_PT_INSTANCE(NAME, SUBNAME, ACCEL_GROUP(__VA_ARGS__), )
 
+/// Registers a group of benchmarks which are compared against the baseline benchmark.
+#define BENCHMARK_GROUP(NAME, BASELINE, ...) \
+    auto ACCEL_UNIQUE = ::accel::Registry::get() \
+        .register_group(#NAME, #BASELINE, #__VA_ARGS__);
+
+/// Registers the instances of a parameterized or templated benchmark as a group which are
+/// compared against the instance with the supplied subname.
+#define BENCHMARK_BASELINE(NAME, SUBNAME) \
+    auto ACCEL_UNIQUE = ::accel::Registry::get() \
+        .register_group(#NAME, #NAME "_" #SUBNAME, nullptr);
+
 //================================================
 // Tests
 //================================================
@@ -186,11 +284,11 @@ private:
 #define ACCEL_TEST_F(FIXTURE, NAME) \
     class ACCEL_CLASS(NAME) : public FIXTURE { \
     protected: \
-        virtual void execute(std::vector<::accel::Failure>& _Accel_failures) override final; \
+        virtual void execute(::accel::Failures& _Accel_failures) override final; \
     }; \
     auto ACCEL_UNIQUE = ::accel::Registry::get() \
         .register_test<ACCEL_CLASS(NAME)>(#NAME, ::accel::Location{__FILE__, __LINE__}); \
-    void ACCEL_CLASS(NAME)::execute(ACCEL_UNUSED std::vector<::accel::Failure>& _Accel_failures)
+    void ACCEL_CLASS(NAME)::execute(ACCEL_UNUSED ::accel::Failures& _Accel_failures)
 
 /// Defines and registers a test.
 #define TEST_F(FIXTURE, NAME) \
@@ -205,10 +303,10 @@ private:
     class ACCEL_CLASS(NAME) : public FIXTURE { \
     protected: \
         template <TYPES> \
-        void execute_pt(std::vector<::accel::Failure>& _Accel_failures, __VA_ARGS__); \
+        void execute_pt(::accel::Failures& _Accel_failures, __VA_ARGS__); \
     }; \
     template <TYPES> \
-    void ACCEL_CLASS(NAME)::execute_pt(std::vector<::accel::Failure>& _Accel_failures, __VA_ARGS__)
+    void ACCEL_CLASS(NAME)::execute_pt(::accel::Failures& _Accel_failures, __VA_ARGS__)
 
 /// Defines a parameterized and templated test.
 #define TEST_PT(NAME, TYPES, ...) \
@@ -0,0 +1,81 @@
+// Copyright 2017 Kyle Mayes
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCEL_STATE_HPP
+#define ACCEL_STATE_HPP
+
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace accel {
+
+/// The state recorded for a benchmark or test instance by a previous run.
+struct InstanceState {
+    /// The amount of time spent running the instance (seconds).
+    double duration = 0.0;
+    /// Whether the instance failed.
+    bool failed = false;
+};
+
+/// The state of benchmark or test instances persisted between runs in a text file.
+///
+/// Each line of the file contains the state of an instance (its duration and whether it passed or
+/// failed) followed by its name, separated by tabs.
+///
+/// Only the instances updated by a run are written back, merged into the current contents of the
+/// file, so concurrent runs which share a file keep the states recorded by each other.
+///
+/// Sharded runs only read the file, since the shards balance the instances by the recorded
+/// durations and would assign them differently if a shard rewrote the file while the others were
+/// starting. The file is updated by unsharded runs.
+class State {
+    std::string path;
+    std::map<std::string, InstanceState> instances;
+    std::set<std::string> updated;
+
+public:
+    /// Reads the state in the file at the supplied path, if it exists.
+    explicit State(std::string path);
+
+    /// Returns the state recorded for the instance with the supplied name, if any.
+    const InstanceState* find(const std::string& name) const;
+    /// Returns the state for the instance with the supplied name to be updated, adding it if
+    /// necessary.
+    InstanceState& get(const std::string& name);
+
+    /// Writes the updated states to the file they were read from, merged into its current
+    /// contents, and returns whether it succeeded.
+    bool write() const;
+};
+
+/// Returns the shard each of the supplied instances is assigned to when split into the supplied
+/// number of shards.
+///
+/// If any durations are supplied, the instances are balanced across the shards by assigning the
+/// longest instances first to the shard with the least total duration (instances without a
+/// duration are assumed to take the mean duration). Otherwise, the instances are assigned by the
+/// hashes of their names. Either way, the assignment only depends on the supplied names and
+/// durations so every shard computes the same assignment.
+std::vector<size_t> assign_shards(
+    const std::vector<std::string>& names,
+    const std::vector<std::optional<double>>& durations,
+    size_t count);
+
+}
+
+#endif
@@ -0,0 +1,194 @@
+// Copyright 2017 Kyle Mayes
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCEL_STATISTICS_HPP
+#define ACCEL_STATISTICS_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace accel {
+
+/// An amount of time represented as a quantity of nanoseconds.
+template <class T>
+using Nanoseconds = std::chrono::duration<T, std::nano>;
+
+/// A sample taken by repeatedly executing a benchmark function.
+struct Sample {
+    /// The number of times the benchmark function was executed.
+    uint64_t iterations;
+    /// The total amount of time spent executing the benchmark function.
+    Nanoseconds<uint64_t> duration;
+    /// The average amount of time spent executing each iteration of the benchmark function.
+    Nanoseconds<double> average;
+    /// The effective frequency of the CPU during the sample (Hz) or zero if it is not known.
+    double frequency = 0.0;
+    /// Whether the sample was collected under changing CPU conditions.
+    bool contaminated = false;
+
+    /// Constructs a benchmark sample.
+    Sample(uint64_t iterations, Nanoseconds<uint64_t> duration);
+};
+
+/// A single-pass and mergeable accumulator of the mean and variance of a series of values.
+///
+/// The values are accumulated with Welford's algorithm and merged with Chan's algorithm.
+struct Moments {
+    /// The number of values accumulated.
+    uint64_t count = 0;
+    /// The mean of the values accumulated.
+    double mean = 0.0;
+    /// The sum of the squared deviations of the values accumulated from their mean.
+    double m2 = 0.0;
+
+    /// Constructs an empty accumulator.
+    Moments() = default;
+
+    /// Accumulates the supplied value.
+    void add(double value);
+    /// Accumulates the values accumulated by the supplied accumulator.
+    void merge(const Moments& other);
+
+    /// Returns the population variance of the values accumulated.
+    double variance() const;
+    /// Returns the population standard deviation of the values accumulated.
+    double stddev() const;
+};
+
+/// A single-pass and mergeable accumulator of the sums required by an OLS linear regression.
+struct Regression {
+    /// The number of points accumulated.
+    uint64_t count = 0;
+    /// The mean of the explanatory variable.
+    double xbar = 0.0;
+    /// The mean of the dependent variable.
+    double ybar = 0.0;
+    /// The sum of the squared deviations of the explanatory variable.
+    double sxx = 0.0;
+    /// The sum of the products of the deviations of the two variables.
+    double sxy = 0.0;
+    /// The sum of the squared deviations of the dependent variable.
+    double syy = 0.0;
+
+    /// Constructs an empty accumulator.
+    Regression() = default;
+
+    /// Accumulates the supplied point.
+    void add(double x, double y);
+    /// Accumulates the points accumulated by the supplied accumulator.
+    void merge(const Regression& other);
+};
+
+/// An ordinary least squares (OLS) linear regression.
+struct LinearRegression {
+    /// The y-intercept.
+    Nanoseconds<double> b0;
+    /// The slope.
+    Nanoseconds<double> b1;
+    /// The goodness of fit.
+    double r2;
+    /// The standard error of the slope.
+    Nanoseconds<double> error;
+
+    /// Calculates and constructs an OLS linear regression.
+    LinearRegression(const Regression& regression);
+    /// Calculates and constructs an OLS linear regression.
+    LinearRegression(const std::vector<Sample>& samples);
+
+    /// Returns the half-width of the 95% confidence interval of the slope relative to the slope
+    /// (or infinity if the slope is not positive).
+    double get_precision() const;
+    /// Returns the lower bound of the 95% confidence interval of the slope.
+    Nanoseconds<double> get_lower() const;
+    /// Returns the upper bound of the 95% confidence interval of the slope.
+    Nanoseconds<double> get_upper() const;
+};
+
+/// The speedup of a benchmark relative to a baseline benchmark.
+struct Speedup {
+    /// The ratio of the estimated time per iteration of the baseline to that of the benchmark.
+    double ratio;
+    /// The lower bound of the 95% confidence interval of the ratio.
+    double lower;
+    /// The upper bound of the 95% confidence interval of the ratio.
+    double upper;
+
+    /// Calculates the speedup from the OLS linear regressions of the benchmarks.
+    ///
+    /// The confidence interval is calculated from the standard errors of the slopes with the delta
+    /// method applied to the logarithm of the ratio, so it is symmetric in relative terms.
+    Speedup(const LinearRegression& baseline, const LinearRegression& benchmark);
+};
+
+/// A fixed-size uniform random subset of a stream of samples.
+///
+/// The subset is maintained with Vitter's algorithm R.
+struct Reservoir {
+    /// The maximum number of samples retained.
+    size_t capacity;
+    /// The number of samples offered.
+    uint64_t seen = 0;
+    /// The samples retained.
+    std::vector<Sample> samples;
+    /// The random number generator used to select the samples retained.
+    std::minstd_rand random;
+
+    /// Constructs an empty reservoir which retains up to the supplied number of samples.
+    Reservoir(size_t capacity);
+
+    /// Offers the supplied sample.
+    void add(Sample sample);
+    /// Offers the samples offered to the supplied reservoir.
+    void merge(const Reservoir& other);
+};
+
+/// Bounded-memory statistics accumulated from a stream of samples.
+struct Statistics {
+    /// The default maximum number of raw samples retained.
+    constexpr static size_t CAPACITY = 1024;
+
+    /// The number of samples accumulated.
+    uint64_t count = 0;
+    /// The total number of iterations of the benchmark function in the samples accumulated.
+    uint64_t iterations = 0;
+    /// The total amount of time spent in the samples accumulated.
+    Nanoseconds<uint64_t> duration{0};
+    /// The moments of the sample averages.
+    Moments averages;
+    /// The regression sums with the sample iterations as the explanatory variable and the sample
+    /// durations as the dependent variable.
+    Regression regression;
+    /// A uniform random subset of the samples accumulated.
+    Reservoir reservoir;
+    /// The number of samples accumulated which were collected under changing CPU conditions.
+    uint64_t contaminated = 0;
+    /// The number of samples discarded because they were collected under changing CPU conditions.
+    uint64_t excluded = 0;
+    /// The moments of the known effective CPU frequencies of the samples accumulated (Hz).
+    Moments frequencies;
+
+    /// Constructs empty statistics which retain up to the supplied number of raw samples.
+    Statistics(size_t capacity = CAPACITY);
+
+    /// Accumulates the supplied sample.
+    void add(Sample sample);
+    /// Accumulates the samples accumulated by the supplied statistics.
+    void merge(const Statistics& other);
+};
+
+}
+
+#endif
@@ -19,6 +19,8 @@
 #include <optional>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -32,9 +34,20 @@ struct Location {
     uint64_t line;
 
     /// Constructs a location.
-    Location(const char* file, uint64_t line);
+    constexpr Location(const char* file, uint64_t line) : file{file}, line{line} { }
 };
 
+namespace detail {
+    /// Whether values of the supplied type are formatted as numbers (unlike `bool` and the
+    /// character types, which streams format differently).
+    template <class T>
+    constexpr bool IS_NUMBER =
+        std::is_same_v<T, short> || std::is_same_v<T, unsigned short> ||
+        std::is_same_v<T, int> || std::is_same_v<T, unsigned int> ||
+        std::is_same_v<T, long> || std::is_same_v<T, unsigned long> ||
+        std::is_same_v<T, long long> || std::is_same_v<T, unsigned long long>;
+}
+
 /// An assertion failure.
 struct Failure {
     /// The location stack of the failed assertion.
@@ -45,36 +58,112 @@ struct Failure {
     std::optional<std::string> message;
     /// Additional information provided by the failed assertion.
     std::vector<std::pair<std::string, std::string>> information;
+    /// Whether the failure will be reported (otherwise the message and information are ignored).
+    bool detailed = true;
 
     /// Constructs an assertion failure.
     Failure(Location location, std::string assertion);
+    /// Constructs an assertion failure which is only described if it will be reported.
+    Failure(Location location, const char* assertion, bool detailed);
 
     /// Appends the supplied argument to the message for this assertion failure.
     template <class T>
     Failure& operator<<(const T& value) {
-        std::stringstream ss;
-        ss << value;
-        if (message) {
-            message->append(ss.str());
+        if (!detailed) {
+            return *this;
+        }
+
+        auto& text = message ? *message : message.emplace();
+        if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+            text.append(std::string_view{value});
+        } else if constexpr (std::is_same_v<T, char>) {
+            text.push_back(value);
+        } else if constexpr (detail::IS_NUMBER<T>) {
+            text.append(std::to_string(value));
         } else {
-            message = ss.str();
+            auto& stream = get_stream();
+            stream << value;
+            text.append(stream.str());
         }
         return *this;
     }
 
     /// Adds a key-value pair to the information for this assertion failure.
     void add_information(std::string key, std::string value);
+
+private:
+    /// Returns an empty stream which is reused to format the arguments of `operator<<`.
+    static std::ostringstream& get_stream();
+};
+
+/// The assertion failures of a test.
+///
+/// Once the supplied number of failures has been stored, further failures are only counted and
+/// the assertions which would produce them are told not to describe them.
+class Failures {
+    uint64_t limit;
+    uint64_t suppressed = 0;
+    std::vector<Failure> failures;
+
+public:
+    /// Constructs an empty collection which stores up to the supplied number of failures.
+    explicit Failures(uint64_t limit = UINT64_MAX);
+
+    /// Returns whether another failure would be stored rather than only counted.
+    bool is_accepting() const { return failures.size() < limit; }
+    /// Returns the number of failures which can still be stored.
+    uint64_t get_remaining() const { return limit - failures.size(); }
+    /// Returns whether no failures have been added.
+    bool empty() const { return failures.empty() && suppressed == 0; }
+    /// Returns the number of stored failures.
+    size_t size() const { return failures.size(); }
+    /// Returns the number of failures which were only counted.
+    uint64_t get_suppressed() const { return suppressed; }
+
+    /// Adds a failure.
+    void push_back(Failure failure);
+    /// Adds the failures of an assertion group, prepending the location of the group assertion
+    /// to their location stacks.
+    void append(Failures&& failures, Location location);
+
+    /// Returns the stored failure with the supplied index.
+    const Failure& get(size_t index) const { return failures[index]; }
+    /// Moves the stored failures out of this collection.
+    std::vector<Failure> take_failures() { return std::move(failures); }
 };
 
 /// A report generated by running a test.
 struct TestReport {
     /// The assertion failures encountered.
     std::vector<Failure> failures;
+    /// The number of assertion failures encountered beyond the failure limit.
+    uint64_t suppressed = 0;
+    /// The amount of time spent in `set_up` (seconds).
+    double set_up = 0.0;
+    /// The amount of time spent in the test function (seconds).
+    double body = 0.0;
+    /// The amount of time spent in `tear_down` (seconds).
+    double tear_down = 0.0;
 
     /// Constructs a test report.
     TestReport(std::vector<Failure> failures);
 };
 
+/// The attributes of a test which affect how it is run.
+struct TestAttributes {
+    /// Whether the test must not run concurrently with any other test.
+    bool serial = false;
+    /// The amount of time the test may run for before it is considered hung (seconds), which
+    /// overrides the default timeout.
+    std::optional<double> timeout;
+    /// The number of assertion failures which are reported before the rest are only counted,
+    /// which overrides the default limit.
+    std::optional<uint64_t> max_failures;
+
+    /// Constructs the default test attributes.
+    TestAttributes() = default;
+};
+
 class Registry;
 
 /// A test.
@@ -82,8 +171,11 @@ class Test {
     friend class Registry;
 
     Location location{"", 0};
+    TestAttributes attributes;
 
 public:
+    /// Called to set the attributes of each instance of this test.
+    static void configure(TestAttributes&) { }
     /// Called once before any instances of this test are executed.
     static void static_set_up() { }
     /// Called once after all instances of this test have been executed.
@@ -99,12 +191,17 @@ public:
     /// Called once after each instance of this test is executed.
     virtual void tear_down() { }
 
-    /// Executes this test and returns a report.
-    TestReport run();
+    /// Returns the attributes of this test.
+    const TestAttributes& get_attributes() const { return attributes; }
+    /// Returns the location this test was defined at.
+    const Location& get_location() const { return location; }
+
+    /// Executes this test and returns a report with up to the supplied number of failures.
+    TestReport run(uint64_t max_failures = UINT64_MAX);
 
 protected:
     /// The user-supplied test function.
-    virtual void execute(std::vector<Failure>& failures) = 0;
+    virtual void execute(Failures& failures) = 0;
 };
 
 }
@@ -0,0 +1,103 @@
+// Copyright 2017 Kyle Mayes
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ACCEL_THREADS_HPP
+#define ACCEL_THREADS_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace accel {
+
+/// A pool of threads which execute a fixed set of jobs.
+///
+/// The jobs are dealt to the threads in order. Each thread executes the jobs it was dealt from the
+/// front of its queue and, once its queue is empty, steals jobs from the back of the queues of the
+/// other threads.
+class ThreadPool {
+public:
+    /// A function which executes the job with the supplied index.
+    using Job = std::function<void(uint64_t)>;
+
+    /// Starts the supplied number of threads which execute the supplied jobs.
+    ThreadPool(size_t threads, const std::vector<uint64_t>& jobs, Job job);
+
+    /// Waits for the jobs to be executed.
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// Waits for the jobs to be executed.
+    void wait();
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<uint64_t> jobs;
+    };
+
+    Job job;
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+
+    void work(size_t index);
+    bool take(size_t index, uint64_t& job);
+};
+
+/// A thread which calls a function when a deadline which has not been disarmed passes.
+class Watchdog {
+public:
+    /// A function which is called with the identifier of an expired deadline.
+    using Expired = std::function<void(uint64_t)>;
+
+    /// Starts a watchdog which calls the supplied function when a deadline passes.
+    explicit Watchdog(Expired expired);
+
+    /// Stops the watchdog.
+    ~Watchdog();
+
+    Watchdog(const Watchdog&) = delete;
+    Watchdog& operator=(const Watchdog&) = delete;
+
+    /// Arms a deadline with the supplied identifier the supplied number of seconds from now.
+    void arm(uint64_t id, double seconds);
+    /// Disarms the deadline with the supplied identifier.
+    void disarm(uint64_t id);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Expired expired;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::map<uint64_t, Clock::time_point> deadlines;
+    bool stopping = false;
+    std::thread thread;
+
+    void watch();
+};
+
+}
+
+#endif
@@ -0,0 +1,279 @@
+// Copyright 2017 Kyle Mayes
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <accelerando/allocation.hpp>
+
+#include <accelerando/profiler.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#if !defined(_WIN32)
+#include <execinfo.h>
+#endif
+
+#if defined(__GNUC__)
+    /// An attribute which inlines the allocation helpers into the allocation functions so that the
+    /// call stack of an allocation always starts with the allocation function.
+    #define ACCEL_ALWAYS_INLINE [[gnu::always_inline]] inline
+#else
+    /// An attribute which inlines the allocation helpers into the allocation functions so that the
+    /// call stack of an allocation always starts with the allocation function.
+    #define ACCEL_ALWAYS_INLINE inline
+#endif
+
+namespace accel {
+
+/// The allocations being counted by the current thread, if any.
+static thread_local Allocations* COUNTING = nullptr;
+
+#if defined(ACCEL_COUNT_ALLOCATIONS)
+/// Counts an allocation of the supplied number of bytes made by the current thread.
+ACCEL_ALWAYS_INLINE static void count_allocation(size_t size) {
+    auto allocations = COUNTING;
+    if (!allocations) {
+        return;
+    }
+
+    allocations->count += 1;
+    allocations->bytes += size;
+#if !defined(_WIN32)
+    if (allocations->trace && allocations->count == 1) {
+        // Unwinding may allocate, so allocations are not counted while unwinding.
+        COUNTING = nullptr;
+        auto depth = ::backtrace(allocations->frames, static_cast<int>(Allocations::DEPTH));
+        allocations->depth = depth > 0 ? static_cast<size_t>(depth) : 0;
+        COUNTING = allocations;
+    }
+#endif
+}
+
+/// Counts a deallocation made by the current thread.
+ACCEL_ALWAYS_INLINE static void count_deallocation(void* pointer) {
+    if (auto allocations = COUNTING; allocations && pointer) {
+        allocations->deallocations += 1;
+    }
+}
+
+/// Allocates the supplied number of bytes with the supplied alignment or returns `nullptr`.
+ACCEL_ALWAYS_INLINE static void* allocate(size_t size, size_t alignment) {
+    size = size != 0 ? size : 1;
+    if (alignment <= alignof(std::max_align_t)) {
+        return std::malloc(size);
+    }
+#if defined(_WIN32)
+    return _aligned_malloc(size, alignment);
+#else
+    void* pointer;
+    return posix_memalign(&pointer, alignment, size) == 0 ? pointer : nullptr;
+#endif
+}
+
+/// Counts and allocates the supplied number of bytes with the supplied alignment, calling the new
+/// handler until the allocation succeeds or there is no new handler.
+ACCEL_ALWAYS_INLINE static void* allocate_counted(size_t size, size_t alignment, bool nothrow) {
+    count_allocation(size);
+    while (true) {
+        if (auto pointer = allocate(size, alignment)) {
+            return pointer;
+        } else if (auto handler = std::get_new_handler()) {
+            handler();
+        } else if (nothrow) {
+            return nullptr;
+        } else {
+#if defined(ACCEL_NO_EXCEPTIONS)
+            std::abort();
+#else
+            throw std::bad_alloc{};
+#endif
+        }
+    }
+}
+
+/// Allocates the supplied number of bytes with the supplied alignment as `operator new` does.
+ACCEL_ALWAYS_INLINE static void* allocate_or_throw(size_t size, size_t alignment) {
+    return allocate_counted(size, alignment, false);
+}
+
+/// Allocates the supplied number of bytes with the supplied alignment or returns `nullptr`.
+ACCEL_ALWAYS_INLINE static void* allocate_or_null(size_t size, size_t alignment) noexcept {
+#if defined(ACCEL_NO_EXCEPTIONS)
+    return allocate_counted(size, alignment, true);
+#else
+    try {
+        return allocate_counted(size, alignment, true);
+    } catch (...) {
+        return nullptr;
+    }
+#endif
+}
+
+/// Deallocates the supplied memory allocated with the supplied alignment.
+ACCEL_ALWAYS_INLINE static void deallocate(void* pointer, size_t alignment) noexcept {
+    count_deallocation(pointer);
+#if defined(_WIN32)
+    if (alignment > alignof(std::max_align_t)) {
+        _aligned_free(pointer);
+        return;
+    }
+#else
+    static_cast<void>(alignment);
+#endif
+    std::free(pointer);
+}
+#endif
+
+bool AllocationCounter::is_enabled() {
+#if defined(ACCEL_COUNT_ALLOCATIONS)
+    return true;
+#else
+    return false;
+#endif
+}
+
+AllocationCounter::AllocationCounter(bool trace) : previous{COUNTING} {
+    allocations.trace = trace;
+    COUNTING = &allocations;
+}
+
+AllocationCounter::~AllocationCounter() {
+    stop();
+}
+
+const Allocations& AllocationCounter::stop() {
+    if (counting) {
+        counting = false;
+        COUNTING = previous;
+        if (previous) {
+            previous->count += allocations.count;
+            previous->bytes += allocations.bytes;
+            previous->deallocations += allocations.deallocations;
+        }
+    }
+    return allocations;
+}
+
+std::vector<std::string> Allocations::get_trace() const {
+    std::vector<std::string> trace;
+#if !defined(_WIN32)
+    // The first frame is the allocation function.
+    for (size_t index = 1; index < depth; ++index) {
+        trace.push_back(symbolize(frames[index]));
+    }
+#endif
+    return trace;
+}
+
+namespace detail {
+    void add_trace(Failure& failure, const Allocations& allocations) {
+        if (!failure.detailed || allocations.depth == 0) {
+            return;
+        }
+
+        auto trace = allocations.get_trace();
+        trace.resize(std::min(trace.size(), ALLOCATION_FRAMES));
+        for (size_t index = 0; index < trace.size(); ++index) {
+            failure.add_information("#" + std::to_string(index), trace[index]);
+        }
+    }
+}
+
+}
+
+#if defined(ACCEL_COUNT_ALLOCATIONS)
+// The replaceable global allocation functions. They replace the allocation functions of any program
+// linked with this library and only add a check of a thread-local pointer to `malloc` and `free`
+// while no allocations are being counted.
+
+void* operator new(size_t size) {
+    return accel::allocate_or_throw(size, 0);
+}
+
+void* operator new[](size_t size) {
+    return accel::allocate_or_throw(size, 0);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return accel::allocate_or_null(size, 0);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return accel::allocate_or_null(size, 0);
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    return accel::allocate_or_throw(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return accel::allocate_or_throw(size, static_cast<size_t>(alignment));
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return accel::allocate_or_null(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return accel::allocate_or_null(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept {
+    accel::deallocate(pointer, 0);
+}
+
+void operator delete[](void* pointer) noexcept {
+    accel::deallocate(pointer, 0);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    accel::deallocate(pointer, 0);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+    accel::deallocate(pointer, 0);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+    accel::deallocate(pointer, 0);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+    accel::deallocate(pointer, 0);
+}
+
+void operator delete(void* pointer, std::align_val_t alignment) noexcept {
+    accel::deallocate(pointer, static_cast<size_t>(alignment));
+}
+
+void operator delete[](void* pointer, std::align_val_t alignment) noexcept {
+    accel::deallocate(pointer, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* pointer, size_t, std::align_val_t alignment) noexcept {
+    accel::deallocate(pointer, static_cast<size_t>(alignment));
+}
+
+void operator delete[](void* pointer, size_t, std::align_val_t alignment) noexcept {
+    accel::deallocate(pointer, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    accel::deallocate(pointer, static_cast<size_t>(alignment));
+}
+
+void operator delete[](void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    accel::deallocate(pointer, static_cast<size_t>(alignment));
+}
+#endif
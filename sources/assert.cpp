@@ -92,28 +92,6 @@ namespace detail {
     std::optional<std::string> stringify(const std::string& value) {
         return stringify(value.data(), value.size());
     }
-
-    template <class T, class I>
-    union Representation {
-        T value;
-        I bits;
-
-        Representation(T value) : value{value} { }
-    };
-
-    template <class T, class I>
-    uint64_t get_ulp_difference(T left, T right) {
-        Representation<T, I> l{left}, r{right};
-        return std::max(l.bits, r.bits) - std::min(l.bits, r.bits);
-    }
-
-    uint64_t get_ulp_difference(float left, float right) {
-        return get_ulp_difference<float, uint32_t>(left, right);
-    }
-
-    uint64_t get_ulp_difference(double left, double right) {
-        return get_ulp_difference<double, uint64_t>(left, right);
-    }
 }
 
 }
@@ -14,112 +14,121 @@
 
 #include <accelerando/benchmark.hpp>
 
+#include <accelerando/profiler.hpp>
+
 #include <algorithm>
+#include <atomic>
 #include <cmath>
-#include <numeric>
+#include <functional>
+#include <memory>
+#include <thread>
 #include <utility>
 
-namespace accel {
-
-Sample::Sample(uint64_t iterations, Nanoseconds<uint64_t> duration)
-    : iterations{iterations}
-    , duration{duration}
-    , average{duration.count() / static_cast<double>(iterations)} { }
-
-/// An implementation of the Kahan summation algorithm for improved floating point sum accuracy.
-struct KahanSummation {
-    double sum = 0.0;
-    double correction = 0.0;
-
-    KahanSummation() { }
-
-    KahanSummation(double sum, double correction) : sum{sum}, correction{correction} { }
-
-    KahanSummation operator+(double value) const {
-        auto y = value - correction;
-        auto t = sum + y;
-        return {t, (t - sum) - y};
-    }
+#if !defined(_WIN32)
+#include <time.h>
+#endif
 
-    KahanSummation operator+(Sample sample) const {
-        return operator+(sample.average.count());
-    }
+namespace accel {
 
-    template <class T>
-    KahanSummation& operator+=(T value) {
-        *this = operator+(value);
-        return *this;
+/// Returns the statistics accumulated from the supplied samples.
+Statistics accumulate_statistics(const std::vector<Sample>& samples) {
+    Statistics statistics;
+    for (auto sample : samples) {
+        statistics.add(sample);
     }
-};
-
-#define RANGE(COLLECTION) COLLECTION.begin(), COLLECTION.end()
-
-double calculate_mean(const std::vector<double>& doubles) {
-    return std::accumulate(RANGE(doubles), KahanSummation{}).sum / doubles.size();
-}
-
-double calculate_mean(const std::vector<Sample>& samples) {
-    return std::accumulate(RANGE(samples), KahanSummation{}).sum / samples.size();
+    return statistics;
 }
 
-double calculate_stddev(const std::vector<Sample>& samples, double mean) {
-    std::vector<double> deviations;
-    deviations.reserve(samples.size());
-    auto f = [=](auto s) { return std::pow(s.average.count() - mean, 2.0); };
-    std::transform(RANGE(samples), std::back_inserter(deviations), f);
-    return std::sqrt(calculate_mean(deviations));
+BenchmarkReport::BenchmarkReport(Statistics statistics)
+    : statistics{std::move(statistics)}
+    , mean{this->statistics.averages.mean}
+    , stddev{this->statistics.averages.stddev()}
+    , ols{this->statistics.regression} { }
+
+BenchmarkReport::BenchmarkReport(const std::vector<Sample>& samples)
+    : BenchmarkReport{accumulate_statistics(samples)} { }
+
+void Attributes::apply(BenchmarkConfig& config) const {
+    config.limit = limit.value_or(config.limit);
+    config.min_samples = min_samples.value_or(config.min_samples);
+    config.max_samples = max_samples.value_or(config.max_samples);
+    config.warm_up = warm_up.value_or(config.warm_up);
+    config.threads = threads.value_or(config.threads);
+    config.clock = clock.value_or(config.clock);
+    config.threshold = threshold.value_or(config.threshold);
 }
 
-Sample operator+(Sample left, Sample right) {
-    return {left.iterations + right.iterations, left.duration + right.duration};
+/// Returns the current time of the supplied clock.
+Nanoseconds<uint64_t> get_time(Clock clock) {
+#if !defined(_WIN32)
+    if (clock != Clock::Wall) {
+        timespec time;
+        clock_gettime(clock == Clock::Process ? CLOCK_PROCESS_CPUTIME_ID : CLOCK_THREAD_CPUTIME_ID,
+            &time);
+        return Nanoseconds<uint64_t>{(time.tv_sec * 1'000'000'000ull) + time.tv_nsec};
+    }
+#endif
+    auto now = std::chrono::high_resolution_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<Nanoseconds<uint64_t>>(now);
 }
 
-LinearRegression::LinearRegression(const std::vector<Sample>& samples) {
-    auto sums = std::accumulate(RANGE(samples), Sample{0, Nanoseconds<uint64_t>{0}});
-    auto xbar = sums.iterations / static_cast<double>(samples.size());
-    auto ybar = sums.duration.count() / static_cast<double>(samples.size());
+/// A team of helper threads which execute a function concurrently with the calling thread.
+///
+/// The helper threads spin between rounds so that the start of each round is not delayed by the
+/// latency of waking a thread.
+class Team {
+    std::function<void()> function;
+    std::vector<std::thread> threads;
+    std::atomic<uint64_t> round{0};
+    std::atomic<uint64_t> iterations{0};
+    std::atomic<uint64_t> running{0};
+    std::atomic<bool> stopping{false};
+
+    void help() {
+        uint64_t seen = 0;
+        while (true) {
+            uint64_t current;
+            while ((current = round.load(std::memory_order_acquire)) == seen) {
+                if (stopping.load(std::memory_order_relaxed)) {
+                    return;
+                }
+                std::this_thread::yield();
+            }
+            seen = current;
 
-    // Calculate the y-intercept and the slope.
-    KahanSummation numerator, denominator;
-    for (auto sample : samples) {
-        auto x = sample.iterations - xbar;
-        numerator += x * (sample.duration.count() - ybar);
-        denominator += std::pow(x, 2.0);
+            auto count = iterations.load(std::memory_order_relaxed);
+            for (uint64_t index = 0; index < count; ++index) {
+                function();
+            }
+            running.fetch_sub(1, std::memory_order_release);
+        }
     }
-    b1 = Nanoseconds<double>{numerator.sum / denominator.sum};
-    b0 = Nanoseconds<double>{ybar - (b1.count() * xbar)};
 
-    // Calculate the goodness of fit.
-    KahanSummation ssr, sst;
-    for (auto sample : samples) {
-        auto f = b0 + (b1 * sample.iterations);
-        ssr += std::pow(sample.duration.count() - f.count(), 2.0);
-        sst += std::pow(sample.duration.count() - ybar, 2.0);
+public:
+    /// Starts the supplied number of helper threads which will execute the supplied function.
+    Team(uint64_t helpers, std::function<void()> function) : function{std::move(function)} {
+        for (uint64_t index = 0; index < helpers; ++index) {
+            threads.emplace_back([this] { help(); });
+        }
     }
-    r2 = 1.0 - (ssr.sum / sst.sum);
-}
-
-BenchmarkReport::BenchmarkReport(std::vector<Sample> samples)
-    : samples{std::move(samples)}
-    , mean{calculate_mean(this->samples)}
-    , stddev{calculate_stddev(this->samples, mean.count())}
-    , ols{this->samples} { }
 
-/// A geometric series which produces non-repeating integers.
-struct GeometricSeries {
-    double value;
-    double ratio;
-
-    GeometricSeries(double value, double ratio) : value{value}, ratio{ratio} { }
+    ~Team() {
+        stopping.store(true, std::memory_order_relaxed);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
 
-    uint64_t next() {
-        auto previous = static_cast<uint64_t>(value);
-        while (true) {
-            value *= ratio;
-            auto current = static_cast<uint64_t>(value);
-            if (current != previous) {
-                return current;
-            }
+    /// Executes the function the supplied number of times on each thread in the team.
+    void run(uint64_t count) {
+        iterations.store(count, std::memory_order_relaxed);
+        running.store(threads.size(), std::memory_order_relaxed);
+        round.fetch_add(1, std::memory_order_release);
+        for (uint64_t index = 0; index < count; ++index) {
+            function();
+        }
+        while (running.load(std::memory_order_acquire) != 0) {
+            std::this_thread::yield();
         }
     }
 };
@@ -137,30 +146,167 @@ struct Stopwatch {
     }
 };
 
-BenchmarkReport Benchmark::run(Nanoseconds<uint64_t> limit) {
-    std::vector<Sample> samples;
+/// Plans the number of iterations in the samples collected by a benchmark.
+///
+/// The iteration counts are spread evenly over the range which is expected to produce samples
+/// with durations in the targeted range so the OLS linear regression has good leverage. The
+/// iteration counts are visited in an interleaved order so that any drift over the course of a
+/// benchmark is not correlated with the iteration counts.
+struct Planner {
+    /// The number of distinct iteration counts the targeted range is divided into.
+    constexpr static uint64_t LEVELS = 16;
+    /// The stride used to interleave the iteration counts (must be coprime with `LEVELS`).
+    constexpr static uint64_t STRIDE = 7;
+
+    const BenchmarkConfig& config;
+    /// The estimated amount of time spent executing each iteration of the benchmark function.
+    double cost;
+    uint64_t lower = 1;
+    uint64_t upper = 1;
+    uint64_t index = 0;
+
+    Planner(const BenchmarkConfig& config, double cost) : config{config}, cost{cost} {
+        plan();
+    }
+
+    /// Recalculates the range of iteration counts from the current cost estimate.
+    void plan() {
+        auto min = config.min_sample_time.count() / cost;
+        auto max = config.max_sample_time.count() / cost;
+        lower = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(min)));
+        upper = std::max<uint64_t>(lower + 1, static_cast<uint64_t>(max));
+    }
+
+    /// Updates the cost estimate with the statistics accumulated so far.
+    void update(const Statistics& statistics) {
+        cost = statistics.duration.count() / static_cast<double>(statistics.iterations);
+        if (statistics.count % LEVELS == 0) {
+            plan();
+        }
+    }
+
+    /// Returns the number of iterations to execute in the next sample or `0` if no sample should
+    /// be collected because it would not complete in the supplied remaining amount of time.
+    uint64_t next(Nanoseconds<uint64_t> remaining) {
+        auto level = (index++ * STRIDE) % LEVELS;
+        auto iterations = lower + (((upper - lower) * level) / (LEVELS - 1));
+
+        // Shorten the sample if it is not expected to complete before the deadline.
+        auto fits = static_cast<uint64_t>(remaining.count() / cost);
+        if (iterations > fits) {
+            iterations = fits;
+        }
+
+        return iterations >= lower ? iterations : 0;
+    }
+};
+
+BenchmarkReport Benchmark::run(const BenchmarkConfig& config) {
+    Statistics statistics;
+    uint64_t executed = 0;
+
+    Monitor monitor;
+    Noise noise;
+    std::unique_ptr<Team> team;
+    auto sample = [&](uint64_t iterations) {
+        executed += iterations;
+        if (config.profiler) {
+            config.profiler->resume();
+        }
+        monitor.start();
+        auto start = get_time(config.clock);
+        if (team) {
+            team->run(iterations);
+        } else {
+            for (uint64_t index = 0; index < iterations; ++index) {
+                execute();
+            }
+        }
+        auto duration = get_time(config.clock) - start;
+        noise = monitor.stop(duration);
+        if (config.profiler) {
+            config.profiler->pause();
+        }
+        return duration;
+    };
+
+    // Accumulates a sample according to the noise policy and returns whether it was accumulated.
+    // The reference frequency is the mean frequency of the uncontaminated samples.
+    Moments reference;
+    auto accumulate = [&](uint64_t iterations, Nanoseconds<uint64_t> duration) {
+        auto contaminated = noise.is_contaminated(reference.mean);
+        if (!contaminated && noise.frequency != 0.0) {
+            reference.add(noise.frequency);
+        } else if (contaminated && config.noise == NoisePolicy::Exclude) {
+            statistics.excluded += 1;
+            return false;
+        } else if (contaminated && config.noise == NoisePolicy::Normalize &&
+                   noise.frequency != 0.0 && reference.count != 0) {
+            auto cycles = duration.count() * noise.frequency;
+            duration = Nanoseconds<uint64_t>{std::llround(cycles / reference.mean)};
+        }
+
+        Sample sample{iterations, duration};
+        sample.frequency = noise.frequency;
+        sample.contaminated = contaminated;
+        statistics.add(sample);
+        return true;
+    };
 
     set_up();
-    GeometricSeries series{1.0, 1.05};
+    if (config.threads > 1) {
+        team = std::make_unique<Team>(config.threads - 1, [this] { execute(); });
+    }
+    for (Stopwatch warm_up; warm_up.get() < config.warm_up;) {
+        execute();
+    }
+    detail::reset_regions();
     Stopwatch stopwatch;
-    while (stopwatch.get() < limit) {
-        auto iterations = series.next();
 
-        // Collect a sample.
-        Stopwatch sample;
-        for (uint64_t index = 0; index < iterations; ++index) {
-            execute();
+    // Run pilot samples with exponentially increasing iteration counts to estimate the cost of
+    // each iteration. Pilot samples which reach the shortest targeted sample duration are kept.
+    uint64_t iterations = 1;
+    auto duration = sample(iterations);
+    while (duration < config.min_sample_time / 8) {
+        auto remaining = config.limit - std::min(config.limit, stopwatch.get());
+        if (2 * duration > remaining) {
+            break;
         }
-        auto duration = sample.get();
+        iterations *= 2;
+        duration = sample(iterations);
+    }
+    if (duration >= config.min_sample_time && config.max_samples != 0) {
+        accumulate(iterations, duration);
+    }
 
-        // Discard the sample if it was shorter than 1 millisecond to reduce noise.
-        if (duration > Nanoseconds<uint64_t>{1'000'000}) {
-            samples.emplace_back(iterations, duration);
+    // Collect the planned samples until the next sample would not complete before the deadline
+    // (unless fewer than the minimum number of samples have been collected).
+    Planner planner{config, std::max(1.0, duration.count() / static_cast<double>(iterations))};
+    while (statistics.count + statistics.excluded < config.max_samples) {
+        auto remaining = config.limit - std::min(config.limit, stopwatch.get());
+        if (statistics.count + statistics.excluded < config.min_samples) {
+            remaining = std::max(remaining, config.max_sample_time);
+        }
+        auto iterations = planner.next(remaining);
+        if (iterations == 0) {
+            break;
+        }
+        if (accumulate(iterations, sample(iterations))) {
+            planner.update(statistics);
         }
     }
+    team.reset();
+    BenchmarkReport report{std::move(statistics)};
+    report.regions = detail::collect_regions(executed);
     tear_down();
 
-    return {std::move(samples)};
+    return report;
+}
+
+BenchmarkReport Benchmark::run(Nanoseconds<uint64_t> limit) {
+    BenchmarkConfig config;
+    config.limit = limit;
+    return run(config);
 }
 
 }
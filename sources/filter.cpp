@@ -0,0 +1,109 @@
+// Copyright 2017 Kyle Mayes
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <accelerando/filter.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+#include <utility>
+
+namespace accel {
+
+bool match_glob(std::string_view pattern, std::string_view name) {
+    // On a mismatch, backtrack to just after the last `*` and let it match one more character.
+    size_t current = 0, matched = 0;
+    size_t star = std::string_view::npos, resume = 0;
+    while (matched < name.size()) {
+        if (current < pattern.size() &&
+            (pattern[current] == '?' || pattern[current] == name[matched])) {
+            current += 1;
+            matched += 1;
+        } else if (current < pattern.size() && pattern[current] == '*') {
+            star = current++;
+            resume = matched;
+        } else if (star != std::string_view::npos) {
+            current = star + 1;
+            matched = ++resume;
+        } else {
+            return false;
+        }
+    }
+    for (; current < pattern.size() && pattern[current] == '*'; ++current) { }
+    return current == pattern.size();
+}
+
+Pattern::Pattern(std::string glob) : glob{std::move(glob)} {
+    prefix = std::min(this->glob.find_first_of("*?"), this->glob.size());
+    if (prefix == this->glob.size()) {
+        kind = Kind::Literal;
+    } else if (prefix + 1 == this->glob.size() && this->glob[prefix] == '*') {
+        kind = Kind::Prefix;
+    } else {
+        kind = Kind::Glob;
+    }
+}
+
+bool Pattern::matches(std::string_view name) const {
+    // Most names are rejected by their first few characters, so compare the literal prefix
+    // before considering any wildcards.
+    if (name.compare(0, prefix, glob, 0, prefix) != 0) {
+        return false;
+    }
+    switch (kind) {
+    case Kind::Literal:
+        return name.size() == prefix;
+    case Kind::Prefix:
+        return true;
+    default:
+        return match_glob(std::string_view{glob}.substr(prefix), name.substr(prefix));
+    }
+}
+
+void Filter::add(const std::string& patterns) {
+    std::istringstream stream{patterns};
+    for (std::string pattern; std::getline(stream, pattern, ',');) {
+        if (pattern.empty()) {
+            continue;
+        } else if (pattern[0] == '-') {
+            excludes.emplace_back(pattern.substr(1));
+        } else {
+            includes.emplace_back(pattern);
+        }
+    }
+}
+
+bool Filter::matches(std::string_view name) const {
+    auto match = [&](const Pattern& pattern) { return pattern.matches(name); };
+    return (includes.empty() || std::any_of(includes.begin(), includes.end(), match)) &&
+        std::none_of(excludes.begin(), excludes.end(), match);
+}
+
+std::vector<size_t> Filter::select(const std::vector<const char*>& names) const {
+    std::vector<size_t> indices;
+    if (includes.empty() && excludes.empty()) {
+        indices.resize(names.size());
+        std::iota(indices.begin(), indices.end(), 0);
+        return indices;
+    }
+
+    for (size_t index = 0; index < names.size(); ++index) {
+        if (matches(names[index])) {
+            indices.push_back(index);
+        }
+    }
+    return indices;
+}
+
+}
@@ -0,0 +1,597 @@
+// Copyright 2017 Kyle Mayes
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <accelerando/fuzz.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iterator>
+
+#if defined(_WIN32)
+#include <direct.h>
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace accel {
+
+//================================================
+// Coverage
+//================================================
+
+/// The hit counters of the edges instrumented with `trace-pc-guard` (indexed by guard, where the
+/// first counter collects the hits of any guards which could not be numbered).
+static uint8_t* GUARD_COUNTERS = nullptr;
+/// The number of guards which have been numbered.
+static uint32_t GUARDS = 0;
+
+/// The number of hit counters of the blocks instrumented with `trace-pc`.
+constexpr static size_t PC_COUNTERS_SIZE = 1 << 16;
+/// The hit counters of the blocks instrumented with `trace-pc` (indexed by a hash of the address).
+static uint8_t PC_COUNTERS[PC_COUNTERS_SIZE];
+/// The indices of the nonzero hit counters of the blocks instrumented with `trace-pc`, so that the
+/// sparse hit counters can be collected without scanning all of them.
+static uint32_t PC_HITS[PC_COUNTERS_SIZE];
+/// The number of nonzero hit counters of the blocks instrumented with `trace-pc`.
+static size_t PC_HIT_COUNT = 0;
+/// Whether any blocks instrumented with `trace-pc` have been hit.
+static bool PC_TRACED = false;
+
+}
+
+#if defined(__GNUC__)
+// The callbacks of the coverage instrumentation of Clang and GCC.
+
+extern "C" void __sanitizer_cov_trace_pc_guard_init(uint32_t* start, uint32_t* stop) {
+    using namespace accel;
+    if (start == stop || *start != 0) {
+        return;
+    }
+
+    auto count = static_cast<size_t>(stop - start);
+    auto size = 1 + static_cast<size_t>(GUARDS) + count;
+    auto counters = static_cast<uint8_t*>(std::realloc(GUARD_COUNTERS, size));
+    if (!counters) {
+        return;
+    }
+    std::memset(counters + 1 + GUARDS, 0, count);
+    GUARD_COUNTERS = counters;
+    for (auto guard = start; guard != stop; ++guard) {
+        *guard = ++GUARDS;
+    }
+}
+
+extern "C" void __sanitizer_cov_trace_pc_guard(uint32_t* guard) {
+    accel::GUARD_COUNTERS[*guard] += 1;
+}
+
+extern "C" void __sanitizer_cov_trace_pc() {
+    using namespace accel;
+    auto pc = reinterpret_cast<uintptr_t>(__builtin_return_address(0));
+    auto index = static_cast<uint32_t>((pc ^ (pc >> 16)) & (PC_COUNTERS_SIZE - 1));
+    if (PC_COUNTERS[index]++ == 0) {
+        PC_HITS[PC_HIT_COUNT++ & (PC_COUNTERS_SIZE - 1)] = index;
+    }
+    PC_TRACED = true;
+}
+#endif
+
+namespace accel {
+
+bool has_coverage() {
+    return GUARDS != 0 || PC_TRACED;
+}
+
+/// Returns the bucket of the supplied nonzero hit count as a bit.
+static uint8_t get_bucket(uint8_t count) {
+    if (count <= 3) {
+        return count == 3 ? 4 : count;
+    } else if (count < 8) {
+        return 8;
+    } else if (count < 16) {
+        return 16;
+    } else if (count < 32) {
+        return 32;
+    } else {
+        return count < 128 ? 64 : 128;
+    }
+}
+
+/// Adds the bucket of the supplied hit counter to the supplied buckets which have been seen,
+/// clearing the hit counter, and returns whether the bucket had not been seen.
+static bool merge_counter(uint8_t& counter, uint8_t& seen, uint64_t& features) {
+    if (counter == 0) {
+        return false;
+    }
+    auto bucket = get_bucket(counter);
+    counter = 0;
+    if ((seen & bucket) != 0) {
+        return false;
+    }
+    seen |= bucket;
+    features += 1;
+    return true;
+}
+
+/// Adds the buckets of the supplied hit counters to the supplied buckets which have been seen,
+/// clearing the hit counters, and returns whether any bucket had not been seen.
+static bool merge_counters(uint8_t* counters, size_t size, uint8_t* seen, uint64_t& features) {
+    auto found = false;
+    auto merge = [&](size_t index) {
+        if (merge_counter(counters[index], seen[index], features)) {
+            found = true;
+        }
+    };
+
+    // Most counters are zero, so they are skipped a word at a time.
+    size_t index = 0;
+    for (; index + sizeof(uint64_t) <= size; index += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, counters + index, sizeof(word));
+        if (word != 0) {
+            for (size_t offset = 0; offset < sizeof(uint64_t); ++offset) {
+                merge(index + offset);
+            }
+        }
+    }
+    for (; index < size; ++index) {
+        merge(index);
+    }
+    return found;
+}
+
+//================================================
+// Corpus
+//================================================
+
+FuzzConfig& get_fuzz_config() {
+    static FuzzConfig config;
+    return config;
+}
+
+/// Returns the FNV-1a hash of the supplied input.
+static uint64_t hash_input(const uint8_t* data, size_t size) {
+    uint64_t hash = 0xCBF29CE484222325;
+    for (size_t index = 0; index < size; ++index) {
+        hash ^= data[index];
+        hash *= 0x100000001B3;
+    }
+    return hash;
+}
+
+/// Writes the supplied hash as 16 hexadecimal digits.
+static void format_hash(uint64_t hash, char* digits) {
+    for (size_t index = 0; index < 16; ++index) {
+        digits[15 - index] = "0123456789abcdef"[(hash >> (4 * index)) & 0xF];
+    }
+}
+
+/// Returns the name of the file the supplied input is written to with the supplied prefix.
+static std::string get_input_name(const char* prefix, const uint8_t* data, size_t size) {
+    char digits[16];
+    format_hash(hash_input(data, size), digits);
+    return prefix + std::string{digits, sizeof(digits)};
+}
+
+std::vector<std::string> list_corpus(const std::string& directory) {
+    std::vector<std::string> paths;
+#if defined(_WIN32)
+    WIN32_FIND_DATAA entry;
+    auto handle = FindFirstFileA((directory + "\\*").c_str(), &entry);
+    if (handle != INVALID_HANDLE_VALUE) {
+        do {
+            if ((entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0) {
+                paths.push_back(directory + "/" + entry.cFileName);
+            }
+        } while (FindNextFileA(handle, &entry));
+        FindClose(handle);
+    }
+#else
+    if (auto stream = opendir(directory.c_str()); stream) {
+        while (auto entry = readdir(stream)) {
+            auto path = directory + "/" + entry->d_name;
+            struct stat status;
+            if (stat(path.c_str(), &status) == 0 && S_ISREG(status.st_mode)) {
+                paths.push_back(std::move(path));
+            }
+        }
+        closedir(stream);
+    }
+#endif
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+/// Returns the contents of the file at the supplied path or nothing if it could not be read.
+static std::optional<std::vector<uint8_t>> read_input(const std::string& path) {
+    std::ifstream file{path, std::ios::binary};
+    if (!file) {
+        return std::nullopt;
+    }
+    std::vector<uint8_t> input{std::istreambuf_iterator<char>{file}, {}};
+    return file.bad() ? std::nullopt : std::optional{std::move(input)};
+}
+
+/// Creates the supplied directory and any missing parent directories.
+static void create_directories(const std::string& directory) {
+    for (size_t end = 0; end != std::string::npos;) {
+        end = directory.find('/', end + 1);
+        auto parent = directory.substr(0, end);
+#if defined(_WIN32)
+        _mkdir(parent.c_str());
+#else
+        mkdir(parent.c_str(), 0777);
+#endif
+    }
+}
+
+/// Writes the supplied input to the supplied file in the supplied directory and returns whether
+/// it was written.
+static bool write_input(const std::string& directory, const std::string& name,
+                        const uint8_t* data, size_t size) {
+    create_directories(directory);
+    std::ofstream file{directory + "/" + name, std::ios::binary};
+    file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+    return static_cast<bool>(file);
+}
+
+/// Executes the supplied fuzz target with the supplied input.
+static void execute_input(Fuzz& target, const uint8_t* data, size_t size, Failures& failures) {
+#if defined(ACCEL_NO_EXCEPTIONS)
+    target.fuzz(data, size, failures);
+#else
+    try {
+        target.fuzz(data, size, failures);
+    } catch (const std::exception& e) {
+        Failure failure{target.get_location(), "Unexpected exception."};
+        failure.add_information("message", e.what());
+        failures.push_back(failure);
+    } catch (...) {
+        failures.push_back(Failure{target.get_location(), "Unexpected exception of unknown type."});
+    }
+#endif
+}
+
+std::string Fuzz::get_directory() const {
+    return get_fuzz_config().corpus + "/" + get_name();
+}
+
+void Fuzz::execute(Failures& failures) {
+    for (const auto& path : list_corpus(get_directory())) {
+        auto input = read_input(path);
+        if (!input) {
+            Failure failure{get_location(), "Unreadable fuzz input."};
+            failure.add_information("input", path);
+            failures.push_back(failure);
+            continue;
+        }
+
+        Failures replayed{failures.get_remaining()};
+        execute_input(*this, input->data(), input->size(), replayed);
+        if (!replayed.empty()) {
+            Failure failure{get_location(), "Fuzz input failed."};
+            failure.add_information("input", path);
+            failures.push_back(failure);
+            failures.append(std::move(replayed), get_location());
+        }
+    }
+}
+
+//================================================
+// Crashes
+//================================================
+
+#if !defined(_WIN32)
+/// Whether an input is being executed.
+static volatile sig_atomic_t CRASH_ACTIVE = 0;
+/// The input being executed, which is written to the crash directory if it crashes.
+static const uint8_t* volatile CRASH_DATA = nullptr;
+/// The size of the input being executed.
+static volatile size_t CRASH_SIZE = 0;
+/// The directory crashing inputs are written to.
+static char CRASH_DIRECTORY[4096];
+
+/// The signals which are handled as crashes.
+constexpr static int CRASH_SIGNALS[] = {SIGABRT, SIGBUS, SIGFPE, SIGILL, SIGSEGV};
+
+/// Writes the supplied string to the standard error stream.
+static void write_error(const char* string) {
+    auto ignored = ::write(STDERR_FILENO, string, std::strlen(string));
+    static_cast<void>(ignored);
+}
+
+/// Writes the input being executed to the crash directory and raises the signal again.
+///
+/// Only async-signal-safe functions are called since the state of the process is unknown.
+static void handle_crash(int signal) {
+    const uint8_t* data = CRASH_DATA;
+    size_t size = CRASH_SIZE;
+    if (CRASH_ACTIVE) {
+        char path[sizeof(CRASH_DIRECTORY) + 32];
+        auto length = std::strlen(CRASH_DIRECTORY);
+        std::memcpy(path, CRASH_DIRECTORY, length);
+        std::memcpy(path + length, "/crash-", 7);
+        format_hash(hash_input(data, size), path + length + 7);
+        path[length + 23] = '\0';
+
+        auto file = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (file >= 0) {
+            for (size_t offset = 0; offset < size;) {
+                auto written = ::write(file, data + offset, size - offset);
+                if (written <= 0) {
+                    break;
+                }
+                offset += static_cast<size_t>(written);
+            }
+            close(file);
+            write_error("\nCRASH: input written to '");
+            write_error(path);
+            write_error("'\n");
+        }
+    }
+
+    // The handler was installed with `SA_RESETHAND`, so the signal now has its default action.
+    raise(signal);
+}
+
+/// The stack crash signals are handled on so that stack overflows can be handled.
+static char CRASH_STACK[1 << 16];
+#endif
+
+/// Handles crash signals while inputs are executed.
+class CrashHandler {
+#if !defined(_WIN32)
+    struct sigaction previous[std::size(CRASH_SIGNALS)];
+#endif
+
+public:
+    explicit CrashHandler(const std::string& directory) {
+#if !defined(_WIN32)
+        std::strncpy(CRASH_DIRECTORY, directory.c_str(), sizeof(CRASH_DIRECTORY) - 1);
+        create_directories(directory);
+
+        stack_t stack = {};
+        stack.ss_sp = CRASH_STACK;
+        stack.ss_size = sizeof(CRASH_STACK);
+        sigaltstack(&stack, nullptr);
+
+        struct sigaction action = {};
+        action.sa_handler = handle_crash;
+        action.sa_flags = SA_ONSTACK | SA_RESETHAND;
+        sigemptyset(&action.sa_mask);
+        for (size_t index = 0; index < std::size(CRASH_SIGNALS); ++index) {
+            sigaction(CRASH_SIGNALS[index], &action, &previous[index]);
+        }
+#else
+        static_cast<void>(directory);
+#endif
+    }
+
+    ~CrashHandler() {
+#if !defined(_WIN32)
+        for (size_t index = 0; index < std::size(CRASH_SIGNALS); ++index) {
+            sigaction(CRASH_SIGNALS[index], &previous[index], nullptr);
+        }
+#endif
+    }
+
+    CrashHandler(const CrashHandler&) = delete;
+    CrashHandler& operator=(const CrashHandler&) = delete;
+};
+
+/// Sets the input which is written to the crash directory if it crashes (or none if null).
+static void set_crash_input(const uint8_t* data, size_t size) {
+#if !defined(_WIN32)
+    CRASH_ACTIVE = 0;
+    CRASH_DATA = data;
+    CRASH_SIZE = size;
+    CRASH_ACTIVE = data != nullptr;
+#else
+    static_cast<void>(data);
+    static_cast<void>(size);
+#endif
+}
+
+//================================================
+// Fuzzer
+//================================================
+
+/// The bytes which are likely to trigger edge cases.
+constexpr static uint8_t INTERESTING[] = {0x00, 0x01, 0x10, 0x20, 0x40, 0x64, 0x7F, 0x80, 0xFF};
+
+/// The maximum number of mutations which are applied to an input before it is executed.
+constexpr static uint64_t STACKED = 4;
+
+Fuzzer::Fuzzer(Fuzz& target, const FuzzConfig& config)
+    : target{target}
+    , config{config}
+    , directory{config.corpus + "/" + target.get_name()}
+    , random{config.seed}
+    , buffer(std::max<uint64_t>(1, config.max_length)) {
+    // Discard the hits recorded before fuzzing started.
+    if (GUARD_COUNTERS) {
+        std::memset(GUARD_COUNTERS, 0, 1 + static_cast<size_t>(GUARDS));
+    }
+    std::memset(PC_COUNTERS, 0, PC_COUNTERS_SIZE);
+    PC_HIT_COUNT = 0;
+}
+
+bool Fuzzer::load() {
+    CrashHandler handler{directory};
+    for (const auto& path : list_corpus(directory)) {
+        if (auto input = read_input(path); input) {
+            if (!execute(input->data(), input->size(), &path)) {
+                return false;
+            }
+            collect();
+            keep(input->data(), input->size(), false);
+        }
+    }
+
+    // Mutations start from an empty input if the corpus is empty.
+    if (entries.empty()) {
+        if (!execute(buffer.data(), 0, nullptr)) {
+            return false;
+        }
+        collect();
+        keep(buffer.data(), 0, false);
+    }
+    return true;
+}
+
+bool Fuzzer::run(uint64_t execs) {
+    CrashHandler handler{directory};
+    for (uint64_t exec = 0; exec < execs; ++exec) {
+        mutate();
+        if (!execute(buffer.data(), length, nullptr)) {
+            return false;
+        }
+        if (collect()) {
+            keep(buffer.data(), length, true);
+        }
+    }
+    return true;
+}
+
+void Fuzzer::mutate() {
+    auto capacity = buffer.size();
+    auto data = buffer.data();
+    auto [offset, size] = entries[random.below(entries.size())];
+    length = std::min(size, capacity);
+    std::memcpy(data, corpus.data() + offset, length);
+
+    for (auto count = 1 + random.below(STACKED); count != 0; --count) {
+        auto kind = length == 0 ? 2 : random.below(8);
+        auto position = random.below(length);
+        switch (kind) {
+        case 0:
+            // Flip a bit.
+            data[position] ^= static_cast<uint8_t>(1 << random.below(8));
+            break;
+        case 1:
+            // Replace a byte.
+            data[position] = static_cast<uint8_t>(random.next());
+            break;
+        case 2:
+            // Insert a byte.
+            if (length < capacity) {
+                position = random.below(length + 1);
+                std::memmove(data + position + 1, data + position, length - position);
+                data[position] = static_cast<uint8_t>(random.next());
+                length += 1;
+            }
+            break;
+        case 3: {
+            // Erase bytes.
+            auto erased = 1 + random.below(std::min<uint64_t>(8, length - position));
+            std::memmove(data + position, data + position + erased, length - position - erased);
+            length -= erased;
+            break;
+        }
+        case 4:
+            // Replace a byte with an interesting byte.
+            data[position] = INTERESTING[random.below(std::size(INTERESTING))];
+            break;
+        case 5:
+            // Add to or subtract from a byte.
+            data[position] += static_cast<uint8_t>(random.below(2) ? 1 + random.below(16)
+                                                                   : 0 - (1 + random.below(16)));
+            break;
+        case 6: {
+            // Copy bytes from elsewhere in the input.
+            auto source = random.below(length);
+            auto copied = 1 + random.below(length - std::max(source, position));
+            std::memmove(data + position, data + source, copied);
+            break;
+        }
+        default: {
+            // Overwrite bytes with bytes from another input in the corpus.
+            auto [other, available] = entries[random.below(entries.size())];
+            if (available != 0) {
+                auto source = random.below(available);
+                auto copied = 1 + random.below(std::min(available - source, length - position));
+                std::memcpy(data + position, corpus.data() + other + source, copied);
+            }
+            break;
+        }
+        }
+    }
+}
+
+bool Fuzzer::execute(const uint8_t* data, size_t size, const std::string* path) {
+    Failures failures;
+    set_crash_input(size != 0 ? data : buffer.data(), size);
+    execute_input(target, data, size, failures);
+    set_crash_input(nullptr, 0);
+    stats.execs += 1;
+    if (failures.empty()) {
+        return true;
+    }
+
+    // Failing inputs are written to the corpus directory so that they are replayed by the test.
+    TestReport report{failures.take_failures()};
+    report.suppressed = failures.get_suppressed();
+    if (path) {
+        crash = FuzzCrash{*path, std::move(report)};
+    } else {
+        auto name = get_input_name("crash-", data, size);
+        write_input(directory, name, data, size);
+        crash = FuzzCrash{directory + "/" + name, std::move(report)};
+    }
+    return false;
+}
+
+bool Fuzzer::collect() {
+    auto guards = GUARD_COUNTERS ? 1 + static_cast<size_t>(GUARDS) : 0;
+    auto size = guards + (PC_TRACED ? PC_COUNTERS_SIZE : 0);
+    if (seen.size() < size) {
+        seen.resize(size);
+    }
+
+    auto found = false;
+    if (guards != 0 && merge_counters(GUARD_COUNTERS, guards, seen.data(), stats.features)) {
+        found = true;
+    }
+    if (PC_TRACED) {
+        auto hits = std::min(PC_HIT_COUNT, PC_COUNTERS_SIZE);
+        for (size_t hit = 0; hit < hits; ++hit) {
+            auto index = PC_HITS[hit];
+            if (merge_counter(PC_COUNTERS[index], seen[guards + index], stats.features)) {
+                found = true;
+            }
+        }
+        PC_HIT_COUNT = 0;
+    }
+    return found;
+}
+
+void Fuzzer::keep(const uint8_t* data, size_t size, bool write) {
+    entries.emplace_back(corpus.size(), size);
+    corpus.insert(corpus.end(), data, data + size);
+    stats.inputs = entries.size();
+    if (write) {
+        write_input(directory, get_input_name("", data, size), data, size);
+        stats.added += 1;
+    }
+}
+
+}
@@ -0,0 +1,249 @@
+// Copyright 2017 Kyle Mayes
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <accelerando/history.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace accel {
+
+/// The header at the start of a history file.
+struct HistoryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t size;
+};
+
+constexpr static HistoryHeader HEADER = {{'A', 'C', 'C', 'E', 'L', 'H', 'I', 'S'}, 1, 64};
+
+uint64_t hash_string(const std::string& string) {
+    uint64_t hash = 0xCBF29CE484222325;
+    for (auto character : string) {
+        hash ^= static_cast<unsigned char>(character);
+        hash *= 0x100000001B3;
+    }
+    return hash;
+}
+
+uint64_t get_host_fingerprint() {
+    std::string fingerprint;
+
+#if !defined(_WIN32)
+    char hostname[256] = {};
+    gethostname(hostname, sizeof(hostname) - 1);
+    fingerprint.append(hostname);
+#endif
+
+    std::ifstream cpuinfo{"/proc/cpuinfo"};
+    for (std::string line; std::getline(cpuinfo, line);) {
+        if (line.compare(0, 10, "model name") == 0) {
+            fingerprint.append(line);
+            break;
+        }
+    }
+
+    fingerprint.append(std::to_string(std::thread::hardware_concurrency()));
+    return hash_string(fingerprint);
+}
+
+std::string get_revision() {
+    if (auto revision = std::getenv("ACCEL_REVISION"); revision) {
+        return revision;
+    }
+
+    std::string revision;
+#if !defined(_WIN32)
+    if (auto pipe = popen("git rev-parse --short=12 HEAD 2>/dev/null", "r"); pipe) {
+        char buffer[64] = {};
+        if (std::fgets(buffer, sizeof(buffer), pipe)) {
+            revision = buffer;
+            revision.erase(revision.find_last_not_of("\r\n") + 1);
+        }
+        pclose(pipe);
+    }
+#endif
+    return revision.empty() ? "unknown" : revision;
+}
+
+History::History(std::string path) : path{std::move(path)} {
+    HistoryHeader header;
+#if defined(_WIN32)
+    std::ifstream file{this->path, std::ios::binary};
+    if (!file) {
+        return;
+    }
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        valid = file.gcount() == 0;
+        return;
+    }
+    valid = std::memcmp(&header, &HEADER, sizeof(header)) == 0;
+    for (HistoryRecord record; valid && file.read(reinterpret_cast<char*>(&record), 64);) {
+        buffer.push_back(record);
+    }
+    records = buffer.data();
+    size = buffer.size();
+#else
+    auto descriptor = open(this->path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        return;
+    }
+
+    struct stat status;
+    if (fstat(descriptor, &status) != 0) {
+        valid = false;
+    } else if (status.st_size >= static_cast<off_t>(sizeof(header))) {
+        length = status.st_size;
+        mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (mapping == MAP_FAILED) {
+            mapping = nullptr;
+            valid = false;
+        } else {
+            valid = std::memcmp(mapping, &HEADER, sizeof(header)) == 0;
+            records = reinterpret_cast<const HistoryRecord*>(
+                static_cast<const char*>(mapping) + sizeof(header));
+            size = valid ? (length - sizeof(header)) / sizeof(HistoryRecord) : 0;
+        }
+    } else {
+        valid = status.st_size == 0;
+    }
+    close(descriptor);
+#endif
+}
+
+History::~History() {
+#if !defined(_WIN32)
+    if (mapping) {
+        munmap(mapping, length);
+    }
+#endif
+}
+
+bool History::append(const HistoryRecord& record) {
+    if (!valid) {
+        return false;
+    }
+
+    std::ofstream file{path, std::ios::binary | std::ios::app};
+    file.seekp(0, std::ios::end);
+    if (file.tellp() == 0) {
+        file.write(reinterpret_cast<const char*>(&HEADER), sizeof(HEADER));
+    }
+    file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    return static_cast<bool>(file);
+}
+
+/// Returns the median of the supplied values.
+double calculate_median(std::vector<double> values) {
+    auto middle = values.begin() + (values.size() / 2);
+    std::nth_element(values.begin(), middle, values.end());
+    return *middle;
+}
+
+std::vector<Changepoint> find_changepoints(const std::vector<double>& values) {
+    constexpr size_t MINIMUM = 2;
+
+    auto count = values.size();
+    if (count < 2 * MINIMUM) {
+        return {};
+    }
+
+    std::vector<double> logs, differences;
+    for (auto value : values) {
+        logs.push_back(std::log(value));
+    }
+    for (size_t index = 1; index < count; ++index) {
+        differences.push_back(std::abs(logs[index] - logs[index - 1]));
+    }
+
+    // Estimate the noise with the median absolute difference between consecutive values, which is
+    // not inflated by step changes, and scale the penalty with the logarithm of the length.
+    auto sigma = std::max(calculate_median(differences) / (0.6745 * std::sqrt(2.0)), 1e-4);
+    auto penalty = 3.0 * sigma * sigma * std::log(static_cast<double>(count));
+
+    std::vector<double> sums{0.0};
+    for (auto log : logs) {
+        sums.push_back(sums.back() + log);
+    }
+    auto mean = [&](size_t start, size_t end) { return (sums[end] - sums[start]) / (end - start); };
+
+    std::vector<size_t> splits;
+    std::vector<std::pair<size_t, size_t>> segments{{0, count}};
+    while (!segments.empty()) {
+        auto [start, end] = segments.back();
+        segments.pop_back();
+
+        // Find the split which most reduces the squared error of the segment.
+        size_t best = 0;
+        double gain = 0.0;
+        for (auto split = start + MINIMUM; split + MINIMUM <= end; ++split) {
+            double left = split - start, right = end - split;
+            auto difference = mean(start, split) - mean(split, end);
+            auto reduction = ((left * right) / (left + right)) * difference * difference;
+            if (reduction > gain) {
+                best = split;
+                gain = reduction;
+            }
+        }
+
+        if (gain > penalty) {
+            splits.push_back(best);
+            segments.emplace_back(start, best);
+            segments.emplace_back(best, end);
+        }
+    }
+
+    std::sort(splits.begin(), splits.end());
+    std::vector<Changepoint> changepoints;
+    for (size_t index = 0; index < splits.size(); ++index) {
+        auto start = index == 0 ? 0 : splits[index - 1];
+        auto end = index + 1 == splits.size() ? count : splits[index + 1];
+        auto before = std::exp(mean(start, splits[index]));
+        auto after = std::exp(mean(splits[index], end));
+        changepoints.push_back({splits[index], before, after});
+    }
+    return changepoints;
+}
+
+double calculate_drift(const std::vector<double>& values) {
+    if (values.size() < 2) {
+        return 0.0;
+    }
+
+    double xbar = (values.size() - 1) / 2.0, ybar = 0.0;
+    for (auto value : values) {
+        ybar += std::log(value) / values.size();
+    }
+
+    double sxx = 0.0, sxy = 0.0;
+    for (size_t index = 0; index < values.size(); ++index) {
+        sxx += (index - xbar) * (index - xbar);
+        sxy += (index - xbar) * (std::log(values[index]) - ybar);
+    }
+    return std::exp(sxy / sxx) - 1.0;
+}
+
+}
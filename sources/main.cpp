@@ -14,12 +14,35 @@
 
 #include <accelerando/main.hpp>
 
+#include <accelerando/filter.hpp>
+#include <accelerando/fuzz.hpp>
+#include <accelerando/history.hpp>
+#include <accelerando/noise.hpp>
+#include <accelerando/performance.hpp>
+#include <accelerando/process.hpp>
+#include <accelerando/profiler.hpp>
+#include <accelerando/property.hpp>
 #include <accelerando/registry.hpp>
+#include <accelerando/state.hpp>
+#include <accelerando/threads.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <ctime>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <map>
+#include <mutex>
+#include <numeric>
+#include <random>
 #include <regex>
+#include <set>
+#include <sstream>
+#include <thread>
 
 #if defined(_WIN32)
 #include <Windows.h>
@@ -78,28 +101,177 @@ constexpr static Color MAGENTA = Color{"\x1B[35m"};
 constexpr static Color CYAN = Color{"\x1B[36m"};
 #endif
 
+/// Buffers colored text to be printed to the console later.
+struct Output {
+    std::vector<std::pair<std::optional<Color>, std::string>> segments;
+
+    /// Buffers the supplied value.
+    template <class T>
+    Output& print(const T& value) {
+        std::ostringstream stream;
+        stream << value;
+        segments.emplace_back(std::nullopt, stream.str());
+        return *this;
+    }
+
+    /// Buffers the supplied value to be printed in the supplied color.
+    template <class T>
+    Output& print(Color color, const T& value) {
+        std::ostringstream stream;
+        stream << value;
+        segments.emplace_back(color, stream.str());
+        return *this;
+    }
+
+    /// Prints and clears the buffered text.
+    void flush() {
+        for (const auto& [color, text] : segments) {
+            if (color) {
+                color->print(text);
+            } else {
+                std::cout << text;
+            }
+        }
+        std::cout.flush();
+        segments.clear();
+    }
+};
+
 /// Stores and parses command-line arguments.
 struct Options {
-    Nanoseconds<uint64_t> limit{5'000'000'000};
-    std::regex regex{".*"};
+    BenchmarkConfig config;
+    Attributes overrides;
+    bool disabled = false;
+    std::optional<Nanoseconds<uint64_t>> budget;
+    Filter filter;
+    std::optional<std::regex> regex;
+    std::optional<std::string> profile;
+    std::optional<uint64_t> workers;
+    Pinning pinning = Pinning::Core;
+    std::optional<std::string> history;
+    bool trend = false;
+    bool list = false;
+    std::optional<std::pair<uint64_t, uint64_t>> shard;
+    std::optional<std::string> state;
+    std::optional<uint64_t> jobs;
+    std::optional<double> timeout;
+    uint64_t max_failures = 100;
+    std::optional<uint64_t> property_cases;
+    std::optional<uint64_t> property_seed;
+    std::optional<uint64_t> property_threads;
+    std::optional<Nanoseconds<uint64_t>> performance_limit;
+    std::optional<uint64_t> performance_rounds;
+    std::optional<double> performance_tolerance;
+    std::optional<std::string> corpus;
+    std::optional<std::string> fuzz;
+    std::optional<uint64_t> fuzz_runs;
+    std::optional<double> fuzz_time;
+    std::optional<uint64_t> max_length;
+    std::optional<uint64_t> slowest;
+    std::optional<std::string> report;
+    bool failed_first = false;
+    bool rerun_failed = false;
+    bool fail_fast = false;
 
     Options() = default;
 
+    void print_option(const char* option, const char* description) {
+        if (std::strlen(option) < 20) {
+            std::printf("  %-20s  %s\n", option, description);
+        } else {
+            std::printf("  %s\n  %-20s  %s\n", option, "", description);
+        }
+    }
+
     void print_help(char* name, bool benchmarks) {
         std::printf("Usage: %s [options]\n\nOptions:\n", name);
         if (benchmarks) {
-            std::printf("  --limit=<number>      Set the benchmark time limit (seconds)\n");
-            std::printf("  --regex=<regex>       Set the benchmark filter\n");
+            print_option("--limit=<number>", "Set the benchmark time limit (seconds)");
+            print_option("--min-samples=<number>", "Set the minimum number of samples");
+            print_option("--max-samples=<number>", "Set the maximum number of samples");
+            print_option("--warm-up=<number>", "Set the benchmark warm-up time (seconds)");
+            print_option("--threads=<number>",
+                "Set the number of threads which execute each benchmark");
+            print_option("--clock=<wall|process|thread>", "Set the clock samples are timed with");
+            print_option("--disabled", "Run benchmarks which are disabled by default");
+            print_option("--budget=<number>",
+                "Set the time limit for all benchmarks and spend it where it is needed (seconds)");
+            print_option("--threshold=<number>",
+                "Set the smallest relative change which matters (default: 0.05)");
+            print_option("--min-sample-time=<number>",
+                "Set the shortest targeted sample duration (seconds)");
+            print_option("--max-sample-time=<number>",
+                "Set the longest targeted sample duration (seconds)");
+            print_option("--profile[=<directory>]",
+                "Write folded stacks sampled from each benchmark");
+            print_option("--filter=<patterns>",
+                "Select benchmarks by comma-separated globs (exclude with a - prefix)");
+            print_option("--regex=<regex>", "Set the benchmark filter");
+            print_option("--workers[=<number>]",
+                "Run benchmarks in parallel pinned worker processes");
+            print_option("--pin=<cpu|core|l3>",
+                "Set the CPUs workers are pinned to (default: core)");
+            print_option("--noise=<keep|exclude|normalize>",
+                "Set how samples collected under changing CPU conditions are handled");
+            print_option("--history=<file>", "Append the results to a history file");
+            print_option("--trend", "Print the trends in the history file instead of running");
         } else {
-            std::printf("  --regex=<regex>       Set the test filter\n");
+            print_option("--filter=<patterns>",
+                "Select tests by comma-separated globs (exclude with a - prefix)");
+            print_option("--regex=<regex>", "Set the test filter");
+            print_option("--jobs[=<number>]", "Run tests in parallel threads");
+            print_option("--workers[=<number>]",
+                "Run tests in parallel crash-isolated worker processes");
+            print_option("--timeout=<number>", "Set the default test timeout (seconds)");
+            print_option("--max-failures=<number>",
+                "Set the number of failures reported for each test (default: 100)");
+            print_option("--property-cases=<number>",
+                "Set the number of cases checked for each property (default: 10000)");
+            print_option("--property-seed=<number>", "Set the seed the cases of properties use");
+            print_option("--property-threads=<number>",
+                "Set the number of threads which check the cases of each property");
+            print_option("--performance-limit=<number>",
+                "Set the time spent measuring each function in each round (seconds)");
+            print_option("--performance-rounds=<number>",
+                "Set the maximum number of rounds of performance assertions (default: 4)");
+            print_option("--performance-tolerance=<number>",
+                "Set the factor by which growth may exceed a complexity (default: 1.5)");
+            print_option("--corpus=<directory>",
+                "Set the directory which contains the corpus of each fuzz target");
+            print_option("--fuzz=<name>", "Fuzz the supplied fuzz target instead of running tests");
+            print_option("--fuzz-runs=<number>", "Set the number of inputs fuzzed");
+            print_option("--fuzz-time=<number>", "Set the amount of time spent fuzzing (seconds)");
+            print_option("--max-length=<number>",
+                "Set the maximum length of fuzzed inputs (default: 4096)");
+            print_option("--slowest[=<number>]", "Print the slowest tests (default: 10)");
+            print_option("--report=<file>", "Write the results and times of the tests as JSON");
+            print_option("--failed-first", "Run the tests which failed in the last run first");
+            print_option("--rerun-failed", "Only run the tests which failed in the last run");
+            print_option("--fail-fast", "Stop running tests after the first failure");
         }
+        print_option("--list", "Print the names of the selected instances instead of running");
+        print_option("--shard=<i>/<n>", "Select the i-th of n balanced subsets (1 <= i <= n)");
+        print_option("--state=<file>",
+            "Read and update the recorded durations and outcomes (only read if sharded)");
     }
 
-    bool parse_limit(const std::string& value) {
+    bool parse_seconds(const std::string& value, Nanoseconds<uint64_t>& seconds) {
         char* end;
         auto number = std::strtod(value.data(), &end);
         if (end == value.data() + value.size()) {
-            limit = Nanoseconds<uint64_t>{static_cast<uint64_t>(1'000'000'000 * number)};
+            seconds = Nanoseconds<uint64_t>{static_cast<uint64_t>(1'000'000'000 * number)};
+            return true;
+        } else {
+            RED.print("ERROR: ");
+            std::cout << "invalid number: '" << value << "'" << std::endl;
+            return false;
+        }
+    }
+
+    bool parse_number(const std::string& value, double& number) {
+        char* end;
+        number = std::strtod(value.data(), &end);
+        if (!value.empty() && end == value.data() + value.size()) {
             return true;
         } else {
             RED.print("ERROR: ");
@@ -108,13 +280,86 @@ struct Options {
         }
     }
 
+    bool parse_integer(const std::string& value, uint64_t& integer) {
+        char* end;
+        auto number = std::strtoull(value.data(), &end, 10);
+        if (!value.empty() && end == value.data() + value.size()) {
+            integer = number;
+            return true;
+        } else {
+            RED.print("ERROR: ");
+            std::cout << "invalid integer: '" << value << "'" << std::endl;
+            return false;
+        }
+    }
+
+    bool parse_pinning(const std::string& value) {
+        if (value == "cpu") {
+            pinning = Pinning::Cpu;
+        } else if (value == "core") {
+            pinning = Pinning::Core;
+        } else if (value == "l3") {
+            pinning = Pinning::Cache;
+        } else {
+            RED.print("ERROR: ");
+            std::cout << "invalid pinning: '" << value << "'" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool parse_clock(const std::string& value) {
+        if (value == "wall") {
+            overrides.clock = Clock::Wall;
+        } else if (value == "process") {
+            overrides.clock = Clock::Process;
+        } else if (value == "thread") {
+            overrides.clock = Clock::Thread;
+        } else {
+            RED.print("ERROR: ");
+            std::cout << "invalid clock: '" << value << "'" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool parse_noise(const std::string& value) {
+        if (value == "keep") {
+            config.noise = NoisePolicy::Keep;
+        } else if (value == "exclude") {
+            config.noise = NoisePolicy::Exclude;
+        } else if (value == "normalize") {
+            config.noise = NoisePolicy::Normalize;
+        } else {
+            RED.print("ERROR: ");
+            std::cout << "invalid noise policy: '" << value << "'" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool parse_shard(const std::string& value) {
+        auto slash = value.find('/');
+        uint64_t index, count;
+        if (slash == std::string::npos || !parse_integer(value.substr(0, slash), index) ||
+            !parse_integer(value.substr(slash + 1), count)) {
+            return false;
+        } else if (index == 0 || index > count) {
+            RED.print("ERROR: ");
+            std::cout << "invalid shard: '" << value << "'" << std::endl;
+            return false;
+        }
+        shard = {index - 1, count};
+        return true;
+    }
+
     bool parse_regex(const std::string& value) {
     #if defined(ACCEL_NO_EXCEPTIONS)
-        regex = std::regex{value};
+        regex.emplace(value);
         return true;
     #else
         try {
-            regex = std::regex{value};
+            regex.emplace(value);
             return true;
         } catch (const std::regex_error&) {
             RED.print("ERROR: ");
@@ -131,19 +376,168 @@ struct Options {
                 print_help(argv[0], benchmarks);
                 return {0};
             } else if (benchmarks && argument.compare(0, 8, "--limit=") == 0) {
-                if (!parse_limit(argument.substr(8))) {
+                if (!parse_seconds(argument.substr(8), overrides.limit.emplace())) {
+                    return {1};
+                }
+            } else if (benchmarks && argument.compare(0, 14, "--min-samples=") == 0) {
+                if (!parse_integer(argument.substr(14), overrides.min_samples.emplace())) {
+                    return {1};
+                }
+            } else if (benchmarks && argument.compare(0, 14, "--max-samples=") == 0) {
+                if (!parse_integer(argument.substr(14), overrides.max_samples.emplace())) {
+                    return {1};
+                }
+            } else if (benchmarks && argument.compare(0, 10, "--warm-up=") == 0) {
+                if (!parse_seconds(argument.substr(10), overrides.warm_up.emplace())) {
+                    return {1};
+                }
+            } else if (benchmarks && argument.compare(0, 10, "--threads=") == 0) {
+                if (!parse_integer(argument.substr(10), overrides.threads.emplace())) {
+                    return {1};
+                }
+            } else if (benchmarks && argument.compare(0, 8, "--clock=") == 0) {
+                if (!parse_clock(argument.substr(8))) {
+                    return {1};
+                }
+            } else if (benchmarks && argument == "--disabled") {
+                disabled = true;
+            } else if (benchmarks && argument.compare(0, 9, "--budget=") == 0) {
+                if (!parse_seconds(argument.substr(9), budget.emplace())) {
+                    return {1};
+                } else if (budget->count() == 0) {
+                    RED.print("ERROR: ");
+                    std::cout << "--budget must be positive" << std::endl;
+                    return {1};
+                }
+            } else if (benchmarks && argument.compare(0, 12, "--threshold=") == 0) {
+                if (!parse_number(argument.substr(12), overrides.threshold.emplace())) {
+                    return {1};
+                }
+            } else if (benchmarks && argument.compare(0, 18, "--min-sample-time=") == 0) {
+                if (!parse_seconds(argument.substr(18), config.min_sample_time)) {
+                    return {1};
+                }
+            } else if (benchmarks && argument.compare(0, 18, "--max-sample-time=") == 0) {
+                if (!parse_seconds(argument.substr(18), config.max_sample_time)) {
+                    return {1};
+                }
+            } else if (benchmarks && argument == "--profile") {
+                profile = ".";
+            } else if (benchmarks && argument.compare(0, 10, "--profile=") == 0) {
+                profile = argument.substr(10);
+            } else if (argument == "--workers") {
+                workers = 0;
+            } else if (argument.compare(0, 10, "--workers=") == 0) {
+                workers = 0;
+                if (!parse_integer(argument.substr(10), *workers)) {
+                    return {1};
+                }
+            } else if (benchmarks && argument.compare(0, 6, "--pin=") == 0) {
+                if (!parse_pinning(argument.substr(6))) {
+                    return {1};
+                }
+            } else if (benchmarks && argument.compare(0, 8, "--noise=") == 0) {
+                if (!parse_noise(argument.substr(8))) {
                     return {1};
                 }
+            } else if (benchmarks && argument.compare(0, 10, "--history=") == 0) {
+                history = argument.substr(10);
+            } else if (benchmarks && argument == "--trend") {
+                trend = true;
+            } else if (argument.compare(0, 9, "--filter=") == 0) {
+                filter.add(argument.substr(9));
             } else if (argument.compare(0, 8, "--regex=") == 0) {
                 if (!parse_regex(argument.substr(8))) {
                     return {1};
                 }
+            } else if (!benchmarks && argument.compare(0, 15, "--max-failures=") == 0) {
+                if (!parse_integer(argument.substr(15), max_failures)) {
+                    return {1};
+                }
+            } else if (!benchmarks && argument.compare(0, 17, "--property-cases=") == 0) {
+                if (!parse_integer(argument.substr(17), property_cases.emplace())) {
+                    return {1};
+                }
+            } else if (!benchmarks && argument.compare(0, 16, "--property-seed=") == 0) {
+                if (!parse_integer(argument.substr(16), property_seed.emplace())) {
+                    return {1};
+                }
+            } else if (!benchmarks && argument.compare(0, 19, "--property-threads=") == 0) {
+                if (!parse_integer(argument.substr(19), property_threads.emplace())) {
+                    return {1};
+                }
+            } else if (!benchmarks && argument.compare(0, 20, "--performance-limit=") == 0) {
+                if (!parse_seconds(argument.substr(20), performance_limit.emplace())) {
+                    return {1};
+                }
+            } else if (!benchmarks && argument.compare(0, 21, "--performance-rounds=") == 0) {
+                if (!parse_integer(argument.substr(21), performance_rounds.emplace())) {
+                    return {1};
+                }
+            } else if (!benchmarks && argument.compare(0, 24, "--performance-tolerance=") == 0) {
+                if (!parse_number(argument.substr(24), performance_tolerance.emplace())) {
+                    return {1};
+                }
+            } else if (!benchmarks && argument.compare(0, 9, "--corpus=") == 0) {
+                corpus = argument.substr(9);
+            } else if (!benchmarks && argument.compare(0, 7, "--fuzz=") == 0) {
+                fuzz = argument.substr(7);
+            } else if (!benchmarks && argument.compare(0, 12, "--fuzz-runs=") == 0) {
+                if (!parse_integer(argument.substr(12), fuzz_runs.emplace())) {
+                    return {1};
+                }
+            } else if (!benchmarks && argument.compare(0, 12, "--fuzz-time=") == 0) {
+                if (!parse_number(argument.substr(12), fuzz_time.emplace())) {
+                    return {1};
+                }
+            } else if (!benchmarks && argument.compare(0, 13, "--max-length=") == 0) {
+                if (!parse_integer(argument.substr(13), max_length.emplace())) {
+                    return {1};
+                }
+            } else if (!benchmarks && argument.compare(0, 10, "--timeout=") == 0) {
+                if (!parse_number(argument.substr(10), timeout.emplace())) {
+                    return {1};
+                }
+            } else if (!benchmarks && argument == "--slowest") {
+                slowest = 10;
+            } else if (!benchmarks && argument.compare(0, 10, "--slowest=") == 0) {
+                if (!parse_integer(argument.substr(10), slowest.emplace())) {
+                    return {1};
+                }
+            } else if (!benchmarks && argument.compare(0, 9, "--report=") == 0) {
+                report = argument.substr(9);
+            } else if (!benchmarks && argument == "--failed-first") {
+                failed_first = true;
+            } else if (!benchmarks && argument == "--rerun-failed") {
+                rerun_failed = true;
+            } else if (!benchmarks && argument == "--fail-fast") {
+                fail_fast = true;
+            } else if (!benchmarks && argument == "--jobs") {
+                jobs = std::thread::hardware_concurrency();
+            } else if (!benchmarks && argument.compare(0, 7, "--jobs=") == 0) {
+                if (!parse_integer(argument.substr(7), jobs.emplace())) {
+                    return {1};
+                }
+            } else if (argument == "--list") {
+                list = true;
+            } else if (argument.compare(0, 8, "--shard=") == 0) {
+                if (!parse_shard(argument.substr(8))) {
+                    return {1};
+                }
+            } else if (argument.compare(0, 8, "--state=") == 0) {
+                state = argument.substr(8);
             } else {
                 RED.print("ERROR: ");
                 std::cout << "invalid argument: '" << argument << "'" << std::endl;
                 return {1};
             }
         }
+
+        if ((failed_first || rerun_failed) && !state) {
+            RED.print("ERROR: ");
+            std::cout << "--failed-first and --rerun-failed require --state" << std::endl;
+            return {1};
+        }
         return {};
     }
 };
@@ -154,6 +548,24 @@ std::string format_file(const std::string& file) {
     return file.substr(start);
 }
 
+std::string format_json(const std::string& string) {
+    std::string json{"\""};
+    for (auto character : string) {
+        if (character == '"' || character == '\\') {
+            json.push_back('\\');
+            json.push_back(character);
+        } else if (static_cast<unsigned char>(character) < 0x20) {
+            char escape[8];
+            std::snprintf(escape, sizeof(escape), "\\u%04x", character);
+            json.append(escape);
+        } else {
+            json.push_back(character);
+        }
+    }
+    json.push_back('"');
+    return json;
+}
+
 std::string format_nanoseconds(double nanoseconds, size_t length) {
     std::pair<double, const char*> display;
     if (nanoseconds < 1'000.0) {
@@ -174,33 +586,373 @@ std::string format_nanoseconds(double nanoseconds, size_t length) {
     return ss.str().substr(0, length) + display.second;
 }
 
+std::string format_sparkline(const std::vector<double>& values, size_t length) {
+    constexpr static const char* BARS[] = {"▁", "▂", "▃", "▄", "▅", "▆", "▇", "█"};
+
+    auto start = values.size() > length ? values.end() - length : values.begin();
+    auto [min, max] = std::minmax_element(start, values.end());
+    std::string sparkline;
+    for (auto value = start; value != values.end(); ++value) {
+        auto range = *max - *min;
+        auto index = range == 0.0 ? 0 : static_cast<size_t>(7.0 * ((*value - *min) / range));
+        sparkline.append(BARS[index]);
+    }
+    return sparkline;
+}
+
 template <class T>
 struct Runner;
 
+/// The result of running a benchmark instance.
+struct BenchmarkResult {
+    BenchmarkReport report;
+    /// A summary of the profile written for the benchmark, if any.
+    std::optional<std::string> profile;
+    /// The errors encountered while running the benchmark.
+    std::vector<std::string> errors;
+    /// The relative slowdown of the canary benchmark around the benchmark, if measured.
+    std::optional<double> interference;
+    /// The amount of time spent running the benchmark (seconds).
+    double elapsed = 0.0;
+
+    BenchmarkResult(BenchmarkReport report) : report{std::move(report)} { }
+};
+
+void encode(Encoder& encoder, const Statistics& statistics) {
+    encoder.write(statistics.count).write(statistics.iterations).write(statistics.duration);
+    encoder.write(statistics.averages).write(statistics.regression);
+    encoder.write<uint64_t>(statistics.reservoir.capacity).write(statistics.reservoir.seen);
+    encoder.write<uint64_t>(statistics.reservoir.samples.size());
+    for (auto sample : statistics.reservoir.samples) {
+        encoder.write(sample.iterations).write(sample.duration);
+        encoder.write(sample.frequency).write(sample.contaminated);
+    }
+    encoder.write(statistics.contaminated).write(statistics.excluded);
+    encoder.write(statistics.frequencies);
+}
+
+Statistics decode_statistics(Decoder& decoder) {
+    Statistics statistics;
+    statistics.count = decoder.read<uint64_t>();
+    statistics.iterations = decoder.read<uint64_t>();
+    statistics.duration = decoder.read<Nanoseconds<uint64_t>>();
+    statistics.averages = decoder.read<Moments>();
+    statistics.regression = decoder.read<Regression>();
+    statistics.reservoir.capacity = decoder.read<uint64_t>();
+    statistics.reservoir.seen = decoder.read<uint64_t>();
+    auto size = decoder.read<uint64_t>();
+    for (uint64_t index = 0; index < size && decoder.is_valid(); ++index) {
+        auto iterations = decoder.read<uint64_t>();
+        auto duration = decoder.read<Nanoseconds<uint64_t>>();
+        auto& sample = statistics.reservoir.samples.emplace_back(iterations, duration);
+        sample.frequency = decoder.read<double>();
+        sample.contaminated = decoder.read<bool>();
+    }
+    statistics.contaminated = decoder.read<uint64_t>();
+    statistics.excluded = decoder.read<uint64_t>();
+    statistics.frequencies = decoder.read<Moments>();
+    return statistics;
+}
+
+std::string encode(const BenchmarkResult& result) {
+    Encoder encoder;
+    encode(encoder, result.report.statistics);
+    encoder.write<uint64_t>(result.report.regions.size());
+    for (const auto& region : result.report.regions) {
+        encoder.write(region.name).write(region.time).write(region.calls);
+    }
+    encoder.write(result.profile.has_value()).write(result.profile.value_or(""));
+    encoder.write<uint64_t>(result.errors.size());
+    for (const auto& error : result.errors) {
+        encoder.write(error);
+    }
+    encoder.write(result.interference.has_value()).write(result.interference.value_or(0.0));
+    encoder.write(result.elapsed);
+    return encoder.get();
+}
+
+std::optional<BenchmarkResult> decode_result(const std::string& data) {
+    Decoder decoder{data};
+    BenchmarkResult result{decode_statistics(decoder)};
+    auto regions = decoder.read<uint64_t>();
+    for (uint64_t index = 0; index < regions && decoder.is_valid(); ++index) {
+        auto name = decoder.read<std::string>();
+        auto time = decoder.read<Nanoseconds<double>>();
+        result.report.regions.emplace_back(std::move(name), time, decoder.read<double>());
+    }
+    if (auto profile = decoder.read<bool>(); profile) {
+        result.profile = decoder.read<std::string>();
+    } else {
+        decoder.read<std::string>();
+    }
+    auto errors = decoder.read<uint64_t>();
+    for (uint64_t index = 0; index < errors && decoder.is_valid(); ++index) {
+        result.errors.push_back(decoder.read<std::string>());
+    }
+    if (auto interference = decoder.read<bool>(); interference) {
+        result.interference = decoder.read<double>();
+    } else {
+        decoder.read<double>();
+    }
+    result.elapsed = decoder.read<double>();
+    return decoder.is_valid() ? std::optional{std::move(result)} : std::nullopt;
+}
+
+/// The result of running a test in a worker process.
+struct TestResult {
+    TestReport report;
+    /// The amount of time spent running the test (seconds).
+    double elapsed = 0.0;
+
+    TestResult(TestReport report) : report{std::move(report)} { }
+};
+
+std::string encode(const TestResult& result) {
+    Encoder encoder;
+    encoder.write<uint64_t>(result.report.failures.size());
+    for (const auto& failure : result.report.failures) {
+        encoder.write<uint64_t>(failure.stack.size());
+        for (auto location : failure.stack) {
+            encoder.write(std::string{location.file}).write(location.line);
+        }
+        encoder.write(failure.assertion);
+        encoder.write(failure.message.has_value()).write(failure.message.value_or(""));
+        encoder.write<uint64_t>(failure.information.size());
+        for (const auto& [key, value] : failure.information) {
+            encoder.write(key).write(value);
+        }
+    }
+    encoder.write(result.report.suppressed);
+    encoder.write(result.report.set_up).write(result.report.body).write(result.report.tear_down);
+    encoder.write(result.elapsed);
+    return encoder.get();
+}
+
+/// Decodes a test result, interning the names of the source files in the supplied set.
+std::optional<TestResult> decode_test_result(const std::string& data,
+                                             std::set<std::string>& files) {
+    Decoder decoder{data};
+    std::vector<Failure> failures;
+    auto count = decoder.read<uint64_t>();
+    for (uint64_t index = 0; index < count && decoder.is_valid(); ++index) {
+        std::vector<Location> stack;
+        auto depth = decoder.read<uint64_t>();
+        for (uint64_t level = 0; level < depth && decoder.is_valid(); ++level) {
+            auto file = files.insert(decoder.read<std::string>()).first->c_str();
+            stack.emplace_back(file, decoder.read<uint64_t>());
+        }
+
+        auto& failure = failures.emplace_back(Location{"", 0}, decoder.read<std::string>());
+        failure.stack = std::move(stack);
+        if (auto message = decoder.read<bool>(); message) {
+            failure.message = decoder.read<std::string>();
+        } else {
+            decoder.read<std::string>();
+        }
+        auto information = decoder.read<uint64_t>();
+        for (uint64_t pair = 0; pair < information && decoder.is_valid(); ++pair) {
+            auto key = decoder.read<std::string>();
+            failure.add_information(std::move(key), decoder.read<std::string>());
+        }
+    }
+
+    TestResult result{std::move(failures)};
+    result.report.suppressed = decoder.read<uint64_t>();
+    result.report.set_up = decoder.read<double>();
+    result.report.body = decoder.read<double>();
+    result.report.tear_down = decoder.read<double>();
+    result.elapsed = decoder.read<double>();
+    return decoder.is_valid() ? std::optional{std::move(result)} : std::nullopt;
+}
+
+/// A benchmark which chases pointers through a buffer larger than most private caches, used to
+/// detect interference from benchmarks running concurrently on other cores.
+class Canary : public Benchmark {
+    constexpr static size_t SIZE = 1 << 19;
+
+    std::vector<uint32_t> next;
+    uint32_t index = 0;
+
+public:
+    Canary() : next(SIZE) {
+        // Link the buffer into a single random cycle with Sattolo's algorithm.
+        std::iota(next.begin(), next.end(), 0);
+        std::minstd_rand random;
+        for (auto size = SIZE; size > 1; --size) {
+            auto other = std::uniform_int_distribution<size_t>{0, size - 2}(random);
+            std::swap(next[size - 1], next[other]);
+        }
+    }
+
+    /// Returns the time per iteration of this benchmark measured for the supplied time limit.
+    double measure(Nanoseconds<uint64_t> limit) {
+        BenchmarkConfig config;
+        config.limit = limit;
+        return run(config).ols.b1.count();
+    }
+
+protected:
+    virtual void execute() override {
+        for (size_t step = 0; step < 256; ++step) {
+            index = next[index];
+        }
+        retain(index);
+    }
+};
+
 template <>
 struct Runner<Benchmark> {
+    std::unique_ptr<Profiler> profiler;
+    std::vector<double> interferences;
+    std::unique_ptr<History> history;
+    HistoryRecord record{};
+    std::map<std::string, LinearRegression> estimates;
+
     Runner() = default;
 
     void handle_start(const std::vector<const Instance<Benchmark>*>& filtered) {
         GREEN.print("╔════════════╗ ");
         MAGENTA.print(std::to_string(filtered.size()) + " benchmark(s).\n");
+        if (!filtered.empty() && Monitor{}.is_restricted()) {
+            YELLOW.print("WARNING: ");
+            std::cout << "cycles are only counted in user mode (perf_event_paranoid)" << std::endl;
+        }
         if (!filtered.empty()) {
             std::cout << std::endl;
         }
     }
 
-    int handle_end() {
+    /// Prints the speedups of the members of the benchmark groups relative to their baselines.
+    void print_groups() {
+        const auto& registry = Registry::get();
+        for (const auto& group : registry.get_groups()) {
+            auto baseline = estimates.find(group.baseline);
+            if (baseline == estimates.end()) {
+                continue;
+            } else if (!group.family && group.members.empty()) {
+                YELLOW.print("\nWARNING: ");
+                std::cout << "benchmark group '" << group.name
+                    << "' has no members other than its baseline" << std::endl;
+                continue;
+            }
+
+            std::vector<std::pair<std::string, Speedup>> speedups;
+            for (const auto& benchmark : registry.get_benchmarks()) {
+                auto estimate = estimates.find(benchmark.name);
+                if (benchmark.name != group.baseline && estimate != estimates.end() &&
+                    group.contains(benchmark.name, benchmark.family)) {
+                    Speedup speedup{baseline->second, estimate->second};
+                    speedups.emplace_back(benchmark.name, speedup);
+                }
+            }
+            if (speedups.empty()) {
+                continue;
+            }
+
+            std::cout << std::endl;
+            CYAN.print(group.name);
+            std::cout << " (baseline: " << group.baseline << ")" << std::endl;
+            for (const auto& [name, speedup] : speedups) {
+                std::printf("  %-32s %8.3f× [%.3f×, %.3f×] ", name.c_str(), speedup.ratio,
+                    speedup.lower, speedup.upper);
+                if (speedup.lower > 1.0) {
+                    GREEN.print("faster");
+                } else if (speedup.upper < 1.0) {
+                    RED.print("slower");
+                } else {
+                    std::cout << "no significant difference";
+                }
+                std::cout << std::endl;
+            }
+        }
+    }
+
+    int handle_end(const Options&) {
+        print_groups();
+        if (!interferences.empty()) {
+            auto [min, max] = std::minmax_element(interferences.begin(), interferences.end());
+            auto sum = std::accumulate(interferences.begin(), interferences.end(), 0.0);
+            std::printf("\nInterference: %+.1f%% mean, %+.1f%% min, %+.1f%% max\n",
+                100.0 * (sum / interferences.size()), 100.0 * *min, 100.0 * *max);
+        }
+
         GREEN.print("\n╚════════════╝ ");
         MAGENTA.print("All benchmarks completed.\n");
         return 0;
     }
 
-    void handle_instance(const Instance<Benchmark>& benchmark, const Options& options) {
+    void write_profile(const std::string& name, const std::string& directory,
+                       BenchmarkResult& result) {
+        auto path = directory + "/" + name + ".folded";
+        std::ofstream file{path};
+        uint64_t samples = 0;
+        for (const auto& [stack, count] : profiler->collect()) {
+            file << name << ";" << stack << " " << count << "\n";
+            samples += count;
+        }
+
+        if (file) {
+            auto summary = path + " (" + std::to_string(samples) + " samples";
+            if (auto dropped = profiler->get_dropped(); dropped != 0) {
+                summary += ", " + std::to_string(dropped) + " dropped";
+            }
+            result.profile = summary + ")";
+        } else {
+            result.errors.push_back("failed to write profile: '" + path + "'");
+        }
+    }
+
+    BenchmarkConfig get_config(const Instance<Benchmark>& benchmark, const Options& options) {
+        auto config = options.config;
+        benchmark.get_attributes().apply(config);
+        options.overrides.apply(config);
+        return config;
+    }
+
+    /// Constructs and runs the supplied benchmark with the supplied configuration.
+    BenchmarkResult run_instance(const Instance<Benchmark>& benchmark, const Options& options,
+                                 BenchmarkConfig config) {
+        auto instance = benchmark.create();
+        instance->set_up();
+        auto started = false;
+        if (options.profile) {
+            if (!profiler) {
+                profiler = std::make_unique<Profiler>();
+            }
+            started = profiler->start();
+            config.profiler = started ? profiler.get() : nullptr;
+        }
+
+        BenchmarkResult result{instance->run(config)};
+        if (options.profile && !started) {
+            result.errors.push_back("failed to start the profiler");
+        } else if (options.profile) {
+            profiler->stop();
+            write_profile(benchmark.name, *options.profile, result);
+        }
+        instance->tear_down();
+        return result;
+    }
+
+    void print_header(const Instance<Benchmark>& benchmark) {
         GREEN.print("┌─RUN────────┐ ");
         CYAN.print(benchmark.name);
         std::cout << std::endl;
+    }
+
+    void print_footer(const Instance<Benchmark>& benchmark) {
+        GREEN.print("└───────DONE─┘ ");
+        CYAN.print(benchmark.name);
+        std::cout << std::endl;
+    }
 
-        auto report = benchmark.instance->run(options.limit);
+    void print_result(const BenchmarkResult& result) {
+        for (const auto& error : result.errors) {
+            RED.print("ERROR: ");
+            std::cout << error << std::endl;
+        }
+
+        const auto& report = result.report;
         BLUE.print(" t: ");
         std::cout << format_nanoseconds(report.ols.b1.count(), 6) << std::endl;
         std::printf("    %.4f R²\n", report.ols.r2);
@@ -208,20 +960,357 @@ struct Runner<Benchmark> {
         std::cout << format_nanoseconds(report.mean.count(), 6) << std::endl;
         BLUE.print(" σ: ");
         std::cout << format_nanoseconds(report.stddev.count(), 6) << std::endl;
+        const auto& statistics = report.statistics;
+        auto contaminated = statistics.contaminated + statistics.excluded;
+        if (statistics.frequencies.count != 0 || contaminated != 0) {
+            BLUE.print(" n: ");
+            if (statistics.frequencies.count != 0) {
+                std::printf("%.3f GHz, ", statistics.frequencies.mean * 1e-9);
+            }
+            auto total = statistics.count + statistics.excluded;
+            std::cout << contaminated << "/" << total << " sample(s) contaminated";
+            if (statistics.excluded != 0) {
+                std::cout << " (" << statistics.excluded << " excluded)";
+            }
+            std::cout << std::endl;
+        }
+        for (const auto& region : report.regions) {
+            BLUE.print(" r: ");
+            std::cout << format_nanoseconds(region.time.count(), 6);
+            auto share = 100.0 * (region.time / report.ols.b1);
+            std::printf(" %5.1f%% %8.2f× ", share, region.calls);
+            std::cout << region.name << std::endl;
+        }
+        if (result.profile) {
+            BLUE.print(" p: ");
+            std::cout << *result.profile << std::endl;
+        }
+        if (result.interference) {
+            BLUE.print(" i: ");
+            std::printf("%+.1f%%\n", 100.0 * *result.interference);
+            interferences.push_back(*result.interference);
+        }
+    }
 
-        GREEN.print("└───────DONE─┘ ");
-        CYAN.print(benchmark.name);
-        std::cout << std::endl;
+    void append_history(const Instance<Benchmark>& benchmark, const BenchmarkResult& result,
+                        const Options& options) {
+        if (!options.history || result.report.statistics.count == 0) {
+            return;
+        }
+
+        if (!history) {
+            history = std::make_unique<History>(*options.history);
+            record.host = get_host_fingerprint();
+            auto revision = get_revision();
+            std::memset(record.revision, 0, sizeof(record.revision));
+            std::memcpy(record.revision, revision.data(),
+                std::min(revision.size(), sizeof(record.revision)));
+        }
+
+        record.name = hash_string(benchmark.name);
+        record.time = static_cast<int64_t>(std::time(nullptr));
+        record.estimate = result.report.ols.b1.count();
+        record.stddev = result.report.stddev.count();
+        record.samples = result.report.statistics.count;
+        if (!history->append(record)) {
+            RED.print("ERROR: ");
+            std::cout << "failed to append to history: '" << *options.history << "'" << std::endl;
+        }
+    }
+
+    void handle_instance(const Instance<Benchmark>& benchmark, const Options& options) {
+        print_header(benchmark);
+        auto result = run_instance(benchmark, options, get_config(benchmark, options));
+        print_result(result);
+        append_history(benchmark, result, options);
+        estimates.emplace(benchmark.name, result.report.ols);
+        print_footer(benchmark);
+    }
+
+    /// Accumulates the samples of the supplied result into the supplied previous result.
+    void merge_result(BenchmarkResult& previous, BenchmarkResult result) {
+        auto statistics = previous.report.statistics;
+        statistics.merge(result.report.statistics);
+        BenchmarkResult merged{BenchmarkReport{std::move(statistics)}};
+        merged.report.regions = std::move(result.report.regions);
+        merged.profile = result.profile ? std::move(result.profile) : std::move(previous.profile);
+        merged.errors = std::move(previous.errors);
+        merged.errors.insert(merged.errors.end(), result.errors.begin(), result.errors.end());
+        previous = std::move(merged);
+    }
+
+    /// Runs the supplied benchmarks within the suite time budget.
+    ///
+    /// Each benchmark is run once with a quarter of the budget shared evenly (but for at least a
+    /// millisecond, so a small budget may be exceeded). The rest of the budget is repeatedly given
+    /// to the benchmark whose estimate is least precise relative to its threshold until every
+    /// estimate is precise enough or the budget is spent. The samples collected by each run of a
+    /// benchmark are merged.
+    void handle_budget(const std::vector<const Instance<Benchmark>*>& filtered,
+                       const Options& options, State* state) {
+        auto start = std::chrono::steady_clock::now();
+        auto budget = *options.budget;
+        auto remaining = [&]() {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            auto spent = std::chrono::duration_cast<Nanoseconds<uint64_t>>(elapsed);
+            return budget - std::min(budget, spent);
+        };
+
+        std::vector<std::optional<BenchmarkResult>> results(filtered.size());
+        std::vector<BenchmarkConfig> configs;
+        std::vector<double> elapsed(filtered.size(), 0.0);
+        for (auto benchmark : filtered) {
+            configs.push_back(get_config(*benchmark, options));
+        }
+
+        auto run = [&](size_t index, Nanoseconds<uint64_t> limit) {
+            auto& benchmark = *filtered[index];
+            auto config = configs[index];
+            config.limit = limit;
+
+            auto start = std::chrono::steady_clock::now();
+            auto result = run_instance(benchmark, options, config);
+            auto duration = std::chrono::steady_clock::now() - start;
+            elapsed[index] += std::chrono::duration<double>{duration}.count();
+
+            if (results[index]) {
+                merge_result(*results[index], std::move(result));
+            } else {
+                results[index] = std::move(result);
+            }
+        };
+
+        // Returns the precision of the estimate of a benchmark relative to its threshold.
+        auto get_precision = [&](size_t index) {
+            return results[index]->report.ols.get_precision() / configs[index].threshold;
+        };
+
+        // Run a short first pass over every benchmark.
+        auto slice = std::max(budget / (4 * std::max<size_t>(1, filtered.size())),
+            Nanoseconds<uint64_t>{1'000'000});
+        for (size_t index = 0; index < filtered.size(); ++index) {
+            run(index, std::min(slice, configs[index].limit));
+        }
+
+        // Spend the rest of the budget on the least precise estimates. The width of a confidence
+        // interval is inversely proportional to the square root of the time spent sampling, so
+        // the time needed to reach the threshold can be estimated from the time spent so far.
+        while (!filtered.empty()) {
+            size_t worst = 0, imprecise = 0;
+            for (size_t index = 0; index < filtered.size(); ++index) {
+                if (get_precision(index) > 1.0) {
+                    imprecise += 1;
+                }
+                if (get_precision(index) > get_precision(worst)) {
+                    worst = index;
+                }
+            }
+
+            auto left = remaining();
+            if (imprecise == 0 || left.count() == 0 || left < slice / 2) {
+                break;
+            }
+
+            auto precision = std::min(get_precision(worst), 1e3);
+            auto needed = Nanoseconds<double>{1e9 * elapsed[worst] * ((precision * precision) - 1)};
+            auto limit = std::min(std::chrono::duration_cast<Nanoseconds<uint64_t>>(needed),
+                std::max(slice, left / imprecise));
+            run(worst, std::min(std::max(limit, slice / 2), left));
+        }
+
+        for (size_t index = 0; index < filtered.size(); ++index) {
+            auto& benchmark = *filtered[index];
+            auto& result = *results[index];
+            print_header(benchmark);
+            print_result(result);
+            BLUE.print(" e: ");
+            std::printf("±%.2f%% (threshold: %.2f%%, %.3f s)\n",
+                100.0 * result.report.ols.get_precision(), 100.0 * configs[index].threshold,
+                elapsed[index]);
+            append_history(benchmark, result, options);
+            estimates.emplace(benchmark.name, result.report.ols);
+            if (state) {
+                state->get(benchmark.name).duration = elapsed[index];
+            }
+            print_footer(benchmark);
+        }
+    }
+
+    /// Prints the trends and step changes recorded in the history file for the supplied
+    /// benchmarks on this host.
+    int handle_trend(const std::vector<const Instance<Benchmark>*>& filtered,
+                     const Options& options) {
+        if (!options.history) {
+            RED.print("ERROR: ");
+            std::cout << "--trend requires --history" << std::endl;
+            return 1;
+        }
+
+        History history{*options.history};
+        if (!history.is_valid()) {
+            RED.print("ERROR: ");
+            std::cout << "invalid history file: '" << *options.history << "'" << std::endl;
+            return 1;
+        }
+
+        GREEN.print("╔════════════╗ ");
+        MAGENTA.print(std::to_string(filtered.size()) + " benchmark trend(s).\n");
+        if (!filtered.empty()) {
+            std::cout << std::endl;
+        }
+
+        auto host = get_host_fingerprint();
+        for (auto benchmark : filtered) {
+            GREEN.print("┌─TREND──────┐ ");
+            CYAN.print(benchmark->name);
+            std::cout << std::endl;
+
+            auto name = hash_string(benchmark->name);
+            std::vector<const HistoryRecord*> records;
+            std::vector<double> estimates;
+            for (const auto& record : history) {
+                if (record.name == name && record.host == host && record.estimate > 0.0) {
+                    records.push_back(&record);
+                    estimates.push_back(record.estimate);
+                }
+            }
+
+            if (!records.empty()) {
+                BLUE.print(" t: ");
+                std::cout << format_nanoseconds(estimates.back(), 6);
+                std::cout << " (" << records.size() << " run(s))" << std::endl;
+                BLUE.print(" s: ");
+                std::cout << format_sparkline(estimates, 48) << std::endl;
+                BLUE.print(" d: ");
+                std::printf("%+.3f%% per run\n", 100.0 * calculate_drift(estimates));
+                for (auto changepoint : find_changepoints(estimates)) {
+                    auto change = (changepoint.after / changepoint.before) - 1.0;
+                    char buffer[64];
+                    std::snprintf(buffer, sizeof(buffer), "%+.1f%%", 100.0 * change);
+                    (change > 0.0 ? RED : GREEN).print(" c: ");
+                    std::cout << buffer << " at ";
+                    auto revision = records[changepoint.index]->revision;
+                    auto length = strnlen(revision, sizeof(HistoryRecord::revision));
+                    std::cout << std::string(revision, length);
+                    std::cout << " (run " << (changepoint.index + 1) << ")" << std::endl;
+                }
+            } else {
+                std::cout << "    No history on this host." << std::endl;
+            }
+
+            GREEN.print("└───────DONE─┘ ");
+            CYAN.print(benchmark->name);
+            std::cout << std::endl;
+        }
+
+        GREEN.print("\n╚════════════╝ ");
+        MAGENTA.print("All benchmark trends printed.\n");
+        return 0;
+    }
+
+    /// Runs the supplied benchmarks in worker processes pinned to disjoint CPUs and prints the
+    /// results in registration order.
+    void handle_parallel(const std::vector<const Instance<Benchmark>*>& filtered,
+                         const Options& options, State* state) {
+        if (!workers_supported()) {
+            RED.print("ERROR: ");
+            std::cout << "worker processes are not supported on this platform" << std::endl;
+            return;
+        }
+
+        auto cpus = get_isolated_cpus(options.pinning);
+        auto count = *options.workers != 0 ? *options.workers : cpus.size();
+        count = std::max<uint64_t>(1, count);
+        if (!cpus.empty() && count > cpus.size()) {
+            YELLOW.print("WARNING: ");
+            std::cout << "only " << cpus.size() << " isolated CPU(s) available" << std::endl;
+        }
+
+        // Measure the canary benchmark before any workers are running as a reference. Workers
+        // measure their own canary so the buffer is allocated in the same way as the reference.
+        auto reference = Canary{}.measure(Nanoseconds<uint64_t>{250'000'000});
+        std::unique_ptr<Canary> canary;
+        auto previous = std::optional<double>{};
+
+        // The static lifecycle functions are run by each worker for the benchmarks it runs.
+        std::set<Lifecycle> lifecycles;
+        auto handler = [&](uint64_t job) {
+            const auto& benchmark = *filtered[job];
+            if (lifecycles.insert(benchmark.lifecycle).second) {
+                benchmark.lifecycle.set_up();
+            }
+
+            if (!canary) {
+                canary = std::make_unique<Canary>();
+            }
+            auto limit = Nanoseconds<uint64_t>{50'000'000};
+            auto before = previous ? *previous : canary->measure(limit);
+            auto start = std::chrono::steady_clock::now();
+            auto result = run_instance(benchmark, options, get_config(benchmark, options));
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            result.elapsed = std::chrono::duration<double>{elapsed}.count();
+            previous = canary->measure(limit);
+            result.interference = (((before + *previous) / 2.0) / reference) - 1.0;
+            return encode(result);
+        };
+        auto finish = [&] {
+            for (auto lifecycle : lifecycles) {
+                lifecycle.tear_down();
+            }
+        };
+        Pool pool{count, cpus, handler, finish};
+
+        std::vector<uint64_t> jobs(filtered.size());
+        std::iota(jobs.begin(), jobs.end(), 0);
+        std::vector<std::optional<std::optional<BenchmarkResult>>> results(filtered.size());
+        std::vector<int> signals(filtered.size(), 0);
+        size_t printed = 0;
+        pool.run(jobs, [&](uint64_t job, std::optional<std::string> data, int signal) {
+            results[job] = data ? decode_result(*data) : std::nullopt;
+            signals[job] = data ? 0 : signal;
+            for (; printed < results.size() && results[printed]; ++printed) {
+                print_header(*filtered[printed]);
+                if (auto& result = *results[printed]; result) {
+                    print_result(*result);
+                    append_history(*filtered[printed], *result, options);
+                    estimates.emplace(filtered[printed]->name, result->report.ols);
+                    if (state) {
+                        state->get(filtered[printed]->name).duration = result->elapsed;
+                    }
+                } else if (signals[printed] == 0) {
+                    RED.print("ERROR: ");
+                    std::cout << "worker exited unexpectedly" << std::endl;
+                } else {
+                    RED.print("ERROR: ");
+                    std::cout << "worker terminated by signal " << signals[printed] << std::endl;
+                }
+                print_footer(*filtered[printed]);
+            }
+        });
     }
 };
 
 template <>
 struct Runner<Test> {
+    /// The outcome and times of a test which has been run.
+    struct Timing {
+        const Instance<Test>* test;
+        bool passed;
+        double set_up;
+        double body;
+        double tear_down;
+    };
+
     uint64_t failures = 0;
+    size_t selected = 0;
+    std::set<std::string> files;
+    std::vector<Timing> timings;
+    std::unique_ptr<Watchdog> watchdog;
 
     Runner() = default;
 
     void handle_start(const std::vector<const Instance<Test>*>& filtered) {
+        selected = filtered.size();
         GREEN.print("╔════════════╗ ");
         MAGENTA.print(std::to_string(filtered.size()) + " test(s).\n");
         if (!filtered.empty()) {
@@ -229,7 +1318,65 @@ struct Runner<Test> {
         }
     }
 
-    int handle_end() {
+    void record(const Instance<Test>& test, const TestReport& report, bool passed) {
+        timings.push_back({&test, passed, report.set_up, report.body, report.tear_down});
+        if (!passed) {
+            failures += 1;
+        }
+    }
+
+    void print_slowest(uint64_t count) {
+        auto sorted = timings;
+        auto total = [](const Timing& timing) {
+            return timing.set_up + timing.body + timing.tear_down;
+        };
+        std::stable_sort(sorted.begin(), sorted.end(), [&](const auto& left, const auto& right) {
+            return total(left) > total(right);
+        });
+        sorted.resize(std::min<size_t>(count, sorted.size()));
+
+        std::cout << "\nSlowest test(s):" << std::endl;
+        for (const auto& timing : sorted) {
+            std::printf("  %10.6f s  ", total(timing));
+            CYAN.print(timing.test->name);
+            std::printf(" (set_up: %.6f s, body: %.6f s, tear_down: %.6f s)\n", timing.set_up,
+                timing.body, timing.tear_down);
+        }
+    }
+
+    bool write_report(const std::string& path) {
+        std::ofstream file{path};
+        file << "[\n";
+        for (size_t index = 0; index < timings.size(); ++index) {
+            const auto& timing = timings[index];
+            const auto& location = timing.test->location;
+            file << "  {\"name\": " << format_json(timing.test->name)
+                << ", \"file\": " << format_json(format_file(location.file))
+                << ", \"line\": " << location.line
+                << ", \"passed\": " << (timing.passed ? "true" : "false")
+                << ", \"set_up\": " << timing.set_up
+                << ", \"body\": " << timing.body
+                << ", \"tear_down\": " << timing.tear_down << "}"
+                << (index + 1 < timings.size() ? ",\n" : "\n");
+        }
+        file << "]\n";
+        return static_cast<bool>(file);
+    }
+
+    int handle_end(const Options& options) {
+        if (options.slowest && !timings.empty()) {
+            print_slowest(*options.slowest);
+        }
+        if (options.report && !write_report(*options.report)) {
+            RED.print("ERROR: ");
+            std::cout << "failed to write report: '" << *options.report << "'" << std::endl;
+        }
+        if (options.fail_fast && failures != 0 && timings.size() < selected) {
+            YELLOW.print("\nSKIPPED: ");
+            std::cout << selected - timings.size() << " test(s) after the first failure"
+                << std::endl;
+        }
+
         if (failures == 0) {
             GREEN.print("\n╚════════════╝ ");
             MAGENTA.print("All tests passed.\n");
@@ -241,12 +1388,12 @@ struct Runner<Test> {
         }
     }
 
-    void handle_instance(const Instance<Test>& test, const Options&) {
-        GREEN.print("┌─RUN────────┐ ");
-        CYAN.print(test.name);
-        std::cout << std::endl;
+    void print_header(Output& output, const Instance<Test>& test) {
+        output.print(GREEN, "┌─RUN────────┐ ").print(CYAN, test.name).print("\n");
+    }
 
-        auto report = test.instance->run();
+    /// Prints the failures and the outcome of a test and returns whether the test passed.
+    bool print_report(Output& output, const Instance<Test>& test, const TestReport& report) {
         for (const auto& failure : report.failures) {
             // Print the location stack.
             std::string padding{" "};
@@ -255,36 +1402,382 @@ struct Runner<Test> {
                 string.append(format_file(location.file));
                 string.push_back(':');
                 string.append(std::to_string(location.line));
-                YELLOW.print(string + ":\n");
+                output.print(YELLOW, string + ":\n");
                 padding.append("  ");
             }
 
             // Print the assertion.
-            std::cout << padding << failure.assertion << std::endl;
+            output.print(padding + failure.assertion + "\n");
 
             // Print the message, if any.
             if (failure.message) {
                 padding.append("  ");
-                std::cout << padding << *failure.message << std::endl;
+                output.print(padding + *failure.message + "\n");
             }
 
             // Print any key-value pairs.
             if (!failure.information.empty()) {
-                std::cout << padding << "  where" << std::endl;
-                for (const auto [key, value] : failure.information) {
-                    std::cout << padding << "    " << key << " = " << value << std::endl;
+                output.print(padding + "  where\n");
+                for (const auto& [key, value] : failure.information) {
+                    output.print(padding + "    " + key + " = " + value + "\n");
                 }
             }
         }
 
-        if (report.failures.empty()) {
-            GREEN.print("└───────PASS─┘ ");
+        // Print the number of failures which were not reported, if any.
+        if (report.suppressed != 0) {
+            auto count = std::to_string(report.suppressed);
+            output.print(YELLOW, " " + count + " more failure(s) not reported\n");
+        }
+
+        auto passed = report.failures.empty() && report.suppressed == 0;
+        if (passed) {
+            output.print(GREEN, "└───────PASS─┘ ");
         } else {
-            failures += 1;
-            RED.print("└───────FAIL─┘ ");
+            output.print(RED, "└───────FAIL─┘ ");
+        }
+        output.print(CYAN, test.name).print("\n");
+        return passed;
+    }
+
+    /// Returns the number of failures of the supplied test which are reported.
+    uint64_t get_max_failures(const Instance<Test>& test, const Options& options) {
+        return test.get_attributes().max_failures.value_or(options.max_failures);
+    }
+
+    /// Returns the amount of time the supplied test may run for (seconds) or zero if unlimited.
+    double get_timeout(const Instance<Test>& test, const Options& options) {
+        return test.get_attributes().timeout.value_or(options.timeout.value_or(0.0));
+    }
+
+    /// Returns the watchdog which reports a test which exceeds its timeout and aborts.
+    Watchdog& get_watchdog() {
+        if (!watchdog) {
+            watchdog = std::make_unique<Watchdog>([](uint64_t id) {
+                const auto& test = *reinterpret_cast<const Instance<Test>*>(id);
+                const auto& location = test.location;
+                std::cout.flush();
+                RED.print("\nTIMEOUT: ");
+                std::cout << test.name << " (" << format_file(location.file) << ":"
+                    << location.line << ") exceeded its timeout" << std::endl;
+                std::abort();
+            });
+        }
+        return *watchdog;
+    }
+
+    void arm(const Instance<Test>& test, const Options& options) {
+        if (auto timeout = get_timeout(test, options); timeout > 0.0) {
+            get_watchdog().arm(reinterpret_cast<uint64_t>(&test), timeout);
+        }
+    }
+
+    void disarm(const Instance<Test>& test) {
+        if (watchdog) {
+            watchdog->disarm(reinterpret_cast<uint64_t>(&test));
+        }
+    }
+
+    /// Fuzzes the fuzz target selected by the supplied options until the requested number of
+    /// inputs have been executed, the requested amount of time has passed, or an input fails.
+    int handle_fuzz(const std::vector<Instance<Test>>& tests, const Options& options) {
+        const auto& targets = Registry::get().get_fuzz_targets();
+        auto target = std::find_if(targets.begin(), targets.end(),
+            [&](const char* name) { return *options.fuzz == name; });
+        auto test = std::find_if(tests.begin(), tests.end(),
+            [&](const auto& test) { return *options.fuzz == test.name; });
+        if (target == targets.end() || test == tests.end()) {
+            RED.print("ERROR: ");
+            std::cout << "unknown fuzz target: '" << *options.fuzz << "'" << std::endl;
+            return 1;
+        }
+
+        Output output;
+        output.print(GREEN, "┌─FUZZ───────┐ ").print(CYAN, test->name).print("\n");
+        if (!has_coverage()) {
+            output.print(YELLOW, " WARNING: ").print("no coverage instrumentation was found ")
+                .print("(-fsanitize-coverage=trace-pc-guard), so the corpus will not grow\n");
+        }
+        output.flush();
+        std::cout.flush();
+
+        using Clock = std::chrono::steady_clock;
+        auto start = Clock::now();
+        auto elapsed = [&] { return std::chrono::duration<double>{Clock::now() - start}.count(); };
+        auto print_stats = [&](const FuzzStats& stats) {
+            auto rate = stats.execs / std::max(elapsed(), 1e-9);
+            std::printf("  %12llu execs  %10.0f execs/s  %6llu inputs (%llu new)  %8llu features\n",
+                static_cast<unsigned long long>(stats.execs), rate,
+                static_cast<unsigned long long>(stats.inputs),
+                static_cast<unsigned long long>(stats.added),
+                static_cast<unsigned long long>(stats.features));
+            std::fflush(stdout);
+        };
+
+        test->lifecycle.set_up();
+        auto instance = test->create();
+        instance->set_up();
+        Fuzzer fuzzer{static_cast<Fuzz&>(*instance), get_fuzz_config()};
+
+        // Check the time every batch of inputs and print the statistics every second.
+        constexpr uint64_t BATCH = 1024;
+        auto runs = options.fuzz_runs.value_or(UINT64_MAX);
+        auto time = options.fuzz_time.value_or(INFINITY);
+        auto passed = fuzzer.load();
+        for (double next = 1.0; passed && fuzzer.get_stats().execs < runs && elapsed() < time;) {
+            passed = fuzzer.run(std::min(BATCH, runs - fuzzer.get_stats().execs));
+            if (elapsed() >= next) {
+                print_stats(fuzzer.get_stats());
+                next = std::floor(elapsed()) + 1.0;
+            }
+        }
+        print_stats(fuzzer.get_stats());
+
+        instance->tear_down();
+        test->lifecycle.tear_down();
+
+        const auto& crash = fuzzer.get_crash();
+        if (crash) {
+            output.print(YELLOW, " input: ").print(crash->path).print("\n");
+        }
+        print_report(output, *test, crash ? crash->report : TestReport{{}});
+        output.flush();
+        return passed ? 0 : 1;
+    }
+
+    void handle_instance(const Instance<Test>& test, const Options& options) {
+        Output output;
+        print_header(output, test);
+        output.flush();
+
+        auto instance = test.create();
+        instance->set_up();
+        arm(test, options);
+        auto report = instance->run(get_max_failures(test, options));
+        disarm(test);
+        instance->tear_down();
+        record(test, report, print_report(output, test, report));
+        output.flush();
+    }
+
+    /// Runs the supplied tests on a pool of threads and prints their results in order.
+    ///
+    /// The static initialization lifecycle function of a fixture is run before the first of its
+    /// tests starts and the static termination lifecycle function is run after the last of its
+    /// tests finishes. Serial tests are run alone after the other tests have finished. If the run
+    /// is to stop at the first failure, tests which have not started once a test fails are skipped.
+    void handle_parallel(const std::vector<const Instance<Test>*>& filtered,
+                         const Options& options, State* state) {
+        struct Group {
+            std::mutex mutex;
+            bool started = false;
+            size_t remaining = 0;
+        };
+
+        std::map<Lifecycle, Group> groups;
+        for (auto test : filtered) {
+            groups[test->lifecycle].remaining += 1;
+        }
+
+        struct Result {
+            Output output;
+            std::optional<TestReport> report;
+            bool passed = false;
+            double elapsed = 0.0;
+        };
+
+        std::vector<std::optional<Result>> results(filtered.size());
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::atomic<bool> stopped{false};
+
+        auto run = [&](uint64_t index) {
+            const auto& test = *filtered[index];
+            auto& group = groups.find(test.lifecycle)->second;
+
+            Result result;
+            if (!options.fail_fast || !stopped) {
+                {
+                    std::lock_guard<std::mutex> lock{group.mutex};
+                    if (!group.started) {
+                        group.started = true;
+                        test.lifecycle.set_up();
+                    }
+                }
+
+                auto start = std::chrono::steady_clock::now();
+                arm(test, options);
+                auto instance = test.create();
+                instance->set_up();
+                print_header(result.output, test);
+                result.report = instance->run(get_max_failures(test, options));
+                result.passed = print_report(result.output, test, *result.report);
+                instance->tear_down();
+                instance.reset();
+                disarm(test);
+                auto elapsed = std::chrono::steady_clock::now() - start;
+                result.elapsed = std::chrono::duration<double>{elapsed}.count();
+                if (!result.passed) {
+                    stopped = true;
+                }
+            }
+
+            {
+                std::lock_guard<std::mutex> lock{group.mutex};
+                if (--group.remaining == 0 && group.started) {
+                    test.lifecycle.tear_down();
+                }
+            }
+
+            std::lock_guard<std::mutex> lock{mutex};
+            results[index] = std::move(result);
+            ready.notify_one();
+        };
+
+        std::vector<uint64_t> jobs;
+        for (size_t index = 0; index < filtered.size(); ++index) {
+            if (!filtered[index]->get_attributes().serial) {
+                jobs.push_back(index);
+            }
+        }
+
+        // Start the watchdog before any threads could race to start it.
+        get_watchdog();
+        ThreadPool pool{std::max<uint64_t>(1, *options.jobs), jobs, run};
+        for (size_t index = 0; index < filtered.size(); ++index) {
+            if (filtered[index]->get_attributes().serial) {
+                pool.wait();
+                run(index);
+            }
+
+            std::unique_lock<std::mutex> lock{mutex};
+            ready.wait(lock, [&] { return results[index].has_value(); });
+            auto result = std::move(*results[index]);
+            lock.unlock();
+            if (!result.report) {
+                continue;
+            }
+
+            result.output.flush();
+            record(*filtered[index], *result.report, result.passed);
+            if (state) {
+                state->get(filtered[index]->name).duration = result.elapsed;
+            }
+        }
+    }
+
+    /// Runs the supplied tests in a pool of worker processes and prints their results in order.
+    ///
+    /// A test which crashes its worker is reported as a failure and the worker is replaced. The
+    /// static lifecycle functions are run by each worker for the tests it runs. Serial tests are
+    /// run by a single worker after the other tests have finished. If the run is to stop at the
+    /// first failure, tests which have not been dispatched once a test fails are skipped.
+    void handle_isolated(const std::vector<const Instance<Test>*>& filtered,
+                         const Options& options, State* state) {
+        if (!workers_supported()) {
+            RED.print("ERROR: ");
+            std::cout << "worker processes are not supported on this platform" << std::endl;
+            failures = filtered.size();
+            return;
+        }
+
+        std::set<Lifecycle> lifecycles;
+        auto handler = [&](uint64_t job) {
+            const auto& test = *filtered[job];
+            if (lifecycles.insert(test.lifecycle).second) {
+                test.lifecycle.set_up();
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            auto instance = test.create();
+            instance->set_up();
+            TestResult result{instance->run(get_max_failures(test, options))};
+            instance->tear_down();
+            instance.reset();
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            result.elapsed = std::chrono::duration<double>{elapsed}.count();
+            return encode(result);
+        };
+        auto finish = [&] {
+            for (auto lifecycle : lifecycles) {
+                lifecycle.tear_down();
+            }
+        };
+
+        std::vector<uint64_t> jobs, serial;
+        for (size_t index = 0; index < filtered.size(); ++index) {
+            auto& target = filtered[index]->get_attributes().serial ? serial : jobs;
+            target.push_back(index);
+        }
+
+        std::vector<std::optional<std::optional<TestResult>>> results(filtered.size());
+        std::vector<int> signals(filtered.size(), 0);
+        auto print = [&](size_t index) {
+            const auto& test = *filtered[index];
+            Output output;
+            print_header(output, test);
+            if (auto& result = *results[index]; result) {
+                record(test, result->report, print_report(output, test, result->report));
+                if (state) {
+                    state->get(test.name).duration = result->elapsed;
+                }
+            } else {
+                std::vector<Failure> crash;
+                if (signals[index] == Pool::TIMEOUT) {
+                    std::ostringstream timeout;
+                    timeout << get_timeout(test, options);
+                    crash.emplace_back(test.location,
+                        "Test exceeded its timeout of " + timeout.str() + " s.");
+                } else if (signals[index] != 0) {
+                    auto number = std::to_string(signals[index]);
+                    crash.emplace_back(test.location,
+                        "Test terminated by signal " + number + ".");
+                    crash.back().add_information("signal", strsignal(signals[index]));
+                } else {
+                    crash.emplace_back(test.location,
+                        "Test worker exited unexpectedly.");
+                }
+                TestReport report{std::move(crash)};
+                if (signals[index] == Pool::TIMEOUT) {
+                    report.body = get_timeout(test, options);
+                }
+                record(test, report, print_report(output, test, report));
+            }
+            output.flush();
+        };
+
+        Pool* active = nullptr;
+        size_t printed = 0;
+        auto done = [&](uint64_t job, std::optional<std::string> data, int signal) {
+            results[job] = data ? decode_test_result(*data, files) : std::nullopt;
+            signals[job] = signal;
+            for (; printed < results.size() && results[printed]; ++printed) {
+                print(printed);
+            }
+            if (options.fail_fast && failures != 0) {
+                active->cancel();
+            }
+        };
+
+        auto count = *options.workers != 0 ? *options.workers : std::thread::hardware_concurrency();
+        auto timeout = [&](uint64_t job) { return get_timeout(*filtered[job], options); };
+        {
+            Pool pool{std::max<uint64_t>(1, count), {}, handler, finish};
+            active = &pool;
+            pool.run(jobs, done, timeout);
+        }
+        if (!serial.empty() && (!options.fail_fast || failures == 0)) {
+            Pool pool{1, {}, handler, finish};
+            active = &pool;
+            pool.run(serial, done, timeout);
+        }
+
+        // Print the tests which finished after a skipped test.
+        for (; printed < results.size(); ++printed) {
+            if (results[printed]) {
+                print(printed);
+            }
         }
-        CYAN.print(test.name);
-        std::cout << std::endl;
     }
 };
 
@@ -296,23 +1789,143 @@ int run(int argc, char* argv[], const std::vector<Instance<T>>& instances) {
         return *code;
     }
 
+    std::optional<State> state;
+    if (options.state) {
+        state.emplace(*options.state);
+    }
+
+    auto& property = get_property_config();
+    property.cases = options.property_cases.value_or(property.cases);
+    property.seed = options.property_seed.value_or(property.seed);
+    property.threads = options.property_threads.value_or(property.threads);
+
+    auto& performance = get_performance_config();
+    performance.limit = options.performance_limit.value_or(performance.limit);
+    performance.rounds = options.performance_rounds.value_or(performance.rounds);
+    performance.tolerance = options.performance_tolerance.value_or(performance.tolerance);
+
+    auto& fuzz = get_fuzz_config();
+    fuzz.corpus = options.corpus.value_or(fuzz.corpus);
+    fuzz.max_length = options.max_length.value_or(fuzz.max_length);
+    if constexpr (std::is_same_v<T, Test>) {
+        if (options.fuzz) {
+            return Runner<Test>{}.handle_fuzz(instances, options);
+        }
+    }
+
     // Collect the filtered instances.
-    std::vector<const Instance<T>*> filtered;
-    std::map<Lifecycle, std::pair<size_t, size_t>> lifecycles;
+    std::vector<const char*> names;
+    names.reserve(instances.size());
     for (const auto& instance : instances) {
-        if (std::regex_match(instance.name, options.regex)) {
+        names.push_back(instance.name);
+    }
+    std::vector<const Instance<T>*> filtered;
+    for (auto index : options.filter.select(names)) {
+        const auto& instance = instances[index];
+        if constexpr (std::is_same_v<T, Benchmark>) {
+            if (instance.get_attributes().disabled && !options.disabled) {
+                continue;
+            }
+        }
+        if (!options.regex || std::regex_match(instance.name, *options.regex)) {
             filtered.push_back(&instance);
-            if (auto iterator = lifecycles.find(instance.lifecycle); iterator != lifecycles.end()) {
-                iterator->second.second += 1;
-            } else {
-                lifecycles.emplace(instance.lifecycle, std::make_pair(0, 1));
+        }
+    }
+
+    // Select the filtered instances in the requested shard.
+    if (options.shard) {
+        std::vector<std::string> names;
+        std::vector<std::optional<double>> durations;
+        for (auto instance : filtered) {
+            names.push_back(instance->name);
+            auto recorded = state ? state->find(instance->name) : nullptr;
+            durations.push_back(recorded ? std::optional{recorded->duration} : std::nullopt);
+        }
+
+        auto shards = assign_shards(names, durations, options.shard->second);
+        std::vector<const Instance<T>*> selected;
+        for (size_t index = 0; index < filtered.size(); ++index) {
+            if (shards[index] == options.shard->first) {
+                selected.push_back(filtered[index]);
             }
         }
+        filtered = std::move(selected);
     }
 
-    // Run the filtered instances.
+    // Select or reorder the filtered instances by the outcomes recorded in the last run.
+    auto failed = [&](const Instance<T>* instance) {
+        auto recorded = state ? state->find(instance->name) : nullptr;
+        return recorded && recorded->failed;
+    };
+    if (options.rerun_failed) {
+        filtered.erase(std::remove_if(filtered.begin(), filtered.end(),
+            [&](auto instance) { return !failed(instance); }), filtered.end());
+    } else if (options.failed_first) {
+        std::stable_partition(filtered.begin(), filtered.end(), failed);
+    }
+
+    if (options.list) {
+        for (auto instance : filtered) {
+            std::cout << instance->name << "\n";
+        }
+        return 0;
+    }
+
+    std::map<Lifecycle, std::pair<size_t, size_t>> lifecycles;
+    for (auto instance : filtered) {
+        if (auto iterator = lifecycles.find(instance->lifecycle); iterator != lifecycles.end()) {
+            iterator->second.second += 1;
+        } else {
+            lifecycles.emplace(instance->lifecycle, std::make_pair(0, 1));
+        }
+    }
+
+    // Write any updated state once the filtered instances have been run. Sharded runs only read the
+    // state so every shard balances the instances with the same durations.
     Runner<T> runner;
+    auto finish = [&](int code) {
+        if constexpr (std::is_same_v<T, Test>) {
+            for (const auto& timing : runner.timings) {
+                if (state) {
+                    state->get(timing.test->name).failed = !timing.passed;
+                }
+            }
+        }
+        if (state && !options.shard && !state->write()) {
+            RED.print("ERROR: ");
+            std::cout << "failed to write state: '" << *options.state << "'" << std::endl;
+        }
+        return code;
+    };
+
+    // Run the filtered instances.
+    if constexpr (std::is_same_v<T, Benchmark>) {
+        if (options.trend) {
+            return runner.handle_trend(filtered, options);
+        }
+    }
     runner.handle_start(filtered);
+    if constexpr (std::is_same_v<T, Benchmark>) {
+        if (options.budget) {
+            for (const auto& lifecycle : lifecycles) {
+                lifecycle.first.set_up();
+            }
+            runner.handle_budget(filtered, options, state ? &*state : nullptr);
+            for (const auto& lifecycle : lifecycles) {
+                lifecycle.first.tear_down();
+            }
+            return finish(runner.handle_end(options));
+        } else if (options.workers) {
+            runner.handle_parallel(filtered, options, state ? &*state : nullptr);
+            return finish(runner.handle_end(options));
+        }
+    } else if (options.workers) {
+        runner.handle_isolated(filtered, options, state ? &*state : nullptr);
+        return finish(runner.handle_end(options));
+    } else if (options.jobs) {
+        runner.handle_parallel(filtered, options, state ? &*state : nullptr);
+        return finish(runner.handle_end(options));
+    }
     for (const auto& instance : filtered) {
         // Run the static initialization lifecycle function if necessary.
         auto iterator = lifecycles.find(instance->lifecycle);
@@ -322,16 +1935,32 @@ int run(int argc, char* argv[], const std::vector<Instance<T>>& instances) {
         }
 
         // Run the instance.
-        instance->instance->set_up();
+        auto start = std::chrono::steady_clock::now();
         runner.handle_instance(*instance, options);
-        instance->instance->tear_down();
+        if (state) {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            state->get(instance->name).duration = std::chrono::duration<double>{elapsed}.count();
+        }
 
         // Run the static termination lifecycle function if necessary.
         if (iterator->second.first == iterator->second.second) {
             iterator->first.tear_down();
         }
+
+        // Stop at the first failure if requested, running the static termination lifecycle
+        // functions of the fixtures which have started.
+        if constexpr (std::is_same_v<T, Test>) {
+            if (options.fail_fast && runner.failures != 0) {
+                for (const auto& [lifecycle, counts] : lifecycles) {
+                    if (counts.first != 0 && counts.first != counts.second) {
+                        lifecycle.tear_down();
+                    }
+                }
+                break;
+            }
+        }
     }
-    return runner.handle_end();
+    return finish(runner.handle_end(options));
 }
 
 int main_benchmarks(int argc, char* argv[]) {
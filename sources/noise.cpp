@@ -0,0 +1,179 @@
+// Copyright 2017 Kyle Mayes
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <accelerando/noise.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <tuple>
+#include <utility>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace accel {
+
+/// The relative difference between two frequencies which is considered a change.
+constexpr static double TOLERANCE = 0.05;
+
+bool Noise::is_contaminated(double reference) const {
+    if (changed || throttles != 0 || migrations != 0) {
+        return true;
+    } else if (frequency == 0.0 || reference == 0.0) {
+        return false;
+    } else {
+        return std::abs(frequency - reference) > TOLERANCE * reference;
+    }
+}
+
+#if defined(__linux__)
+/// Returns the integer in the supplied file or zero if it could not be read.
+uint64_t read_counter(const std::string& path) {
+    unsigned long long value = 0;
+    if (auto file = std::fopen(path.c_str(), "r"); file) {
+        if (std::fscanf(file, "%llu", &value) != 1) {
+            value = 0;
+        }
+        std::fclose(file);
+    }
+    return value;
+}
+
+/// Returns the number of thermal throttling events recorded for the supplied CPU.
+uint64_t read_throttles(int cpu) {
+    auto directory = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/thermal_throttle";
+    return read_counter(directory + "/core_throttle_count") +
+        read_counter(directory + "/package_throttle_count");
+}
+
+/// Returns the current frequency of the supplied CPU (kHz) or zero if it could not be read.
+uint64_t read_frequency(int cpu) {
+    auto path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/scaling_cur_freq";
+    return read_counter(path);
+}
+
+/// Opens a counter for the calling thread which counts the supplied event in user mode and, unless
+/// restricted, in kernel mode and, if requested, the time the counter was running.
+int open_counter(uint32_t type, uint64_t config, bool running, bool restricted) {
+    perf_event_attr attributes{};
+    attributes.size = sizeof(attributes);
+    attributes.type = type;
+    attributes.config = config;
+    attributes.read_format = running ? PERF_FORMAT_TOTAL_TIME_RUNNING : 0;
+    attributes.exclude_kernel = restricted ? 1 : 0;
+    attributes.exclude_hv = restricted ? 1 : 0;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+}
+
+/// Returns the value of the supplied counter.
+uint64_t read_value(int counter) {
+    uint64_t value = 0;
+    if (::read(counter, &value, sizeof(value)) != sizeof(value)) {
+        value = 0;
+    }
+    return value;
+}
+
+/// Returns the value of the supplied counter and the time it was running (nanoseconds).
+std::pair<uint64_t, uint64_t> read_running(int counter) {
+    uint64_t values[2] = {0, 0};
+    if (::read(counter, values, sizeof(values)) != sizeof(values)) {
+        return {0, 0};
+    }
+    return {values[0], values[1]};
+}
+
+Monitor::Monitor() {
+    // Counting in kernel mode is not permitted for unprivileged users if `perf_event_paranoid` is
+    // at least 2. Cycles are then only counted in user mode, which understates the frequency of
+    // samples which spend time in system calls. Migrations are only counted in kernel mode, so
+    // they are detected by comparing CPUs instead.
+    cycles = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, true, false);
+    if (cycles < 0 && errno == EACCES) {
+        cycles = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, true, true);
+        restricted = cycles >= 0;
+    }
+    migrations = open_counter(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS, false, false);
+}
+
+Monitor::~Monitor() {
+    if (cycles >= 0) {
+        close(cycles);
+    }
+    if (migrations >= 0) {
+        close(migrations);
+    }
+}
+
+void Monitor::start() {
+    cpu = sched_getcpu();
+    throttles_start = cpu >= 0 ? read_throttles(cpu) : 0;
+    if (cycles >= 0) {
+        std::tie(cycles_start, running_start) = read_running(cycles);
+    } else if (cpu >= 0) {
+        frequency_start = read_frequency(cpu);
+    }
+    if (migrations >= 0) {
+        migrations_start = read_value(migrations);
+    }
+}
+
+Noise Monitor::stop(Nanoseconds<uint64_t> duration) {
+    Noise noise;
+    if (migrations >= 0) {
+        noise.migrations = read_value(migrations) - migrations_start;
+    }
+    if (cycles >= 0 && duration.count() != 0) {
+        // The cycles are divided by the time the thread was running rather than by the duration
+        // so that the frequency does not read low when the thread was preempted.
+        auto [cycles_stop, running_stop] = read_running(cycles);
+        if (running_stop > running_start) {
+            auto elapsed = cycles_stop - cycles_start;
+            noise.frequency = elapsed / ((running_stop - running_start) * 1e-9);
+        }
+    }
+
+    auto current = sched_getcpu();
+    if (current != cpu) {
+        noise.migrations = std::max<uint64_t>(noise.migrations, 1);
+    } else if (cpu >= 0) {
+        noise.throttles = read_throttles(cpu) - throttles_start;
+        auto frequency_stop = cycles < 0 && frequency_start != 0 ? read_frequency(cpu) : 0;
+        if (frequency_stop != 0) {
+            auto difference = std::abs(static_cast<double>(frequency_stop) - frequency_start);
+            noise.changed = difference > TOLERANCE * frequency_start;
+            noise.frequency = 500.0 * (frequency_start + frequency_stop);
+        }
+    }
+    return noise;
+}
+#else
+Monitor::Monitor() { }
+
+Monitor::~Monitor() { }
+
+void Monitor::start() { }
+
+Noise Monitor::stop(Nanoseconds<uint64_t>) {
+    return {};
+}
+#endif
+
+}
@@ -0,0 +1,123 @@
+// Copyright 2017 Kyle Mayes
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <accelerando/performance.hpp>
+
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace accel {
+
+double get_growth(Complexity complexity, double size) {
+    switch (complexity) {
+    case Complexity::Constant:
+        return 1.0;
+    case Complexity::Logarithmic:
+        return std::log2(size);
+    case Complexity::Linear:
+        return size;
+    case Complexity::Linearithmic:
+        return size * std::log2(size);
+    case Complexity::Quadratic:
+        return size * size;
+    case Complexity::Cubic:
+        return size * size * size;
+    }
+    return 1.0;
+}
+
+const char* get_name(Complexity complexity) {
+    switch (complexity) {
+    case Complexity::Constant:
+        return "O(1)";
+    case Complexity::Logarithmic:
+        return "O(log n)";
+    case Complexity::Linear:
+        return "O(n)";
+    case Complexity::Linearithmic:
+        return "O(n log n)";
+    case Complexity::Quadratic:
+        return "O(n²)";
+    case Complexity::Cubic:
+        return "O(n³)";
+    }
+    return "O(?)";
+}
+
+PerformanceConfig& get_performance_config() {
+    static PerformanceConfig config;
+    return config;
+}
+
+BenchmarkConfig PerformanceConfig::get_benchmark_config() const {
+    // Short samples are targeted so that each round collects enough samples to bound the time per
+    // iteration and samples collected under changing CPU conditions are discarded.
+    BenchmarkConfig config;
+    config.limit = limit;
+    config.min_sample_time = Nanoseconds<uint64_t>{100'000};
+    config.max_sample_time = Nanoseconds<uint64_t>{1'000'000};
+    config.warm_up = Nanoseconds<uint64_t>{1'000'000};
+    config.min_samples = 8;
+    config.noise = NoisePolicy::Exclude;
+    return config;
+}
+
+namespace detail {
+    Side compare_interval(double lower, double upper, double bound) {
+        if (upper < bound) {
+            return Side::Below;
+        } else if (lower > bound) {
+            return Side::Above;
+        } else {
+            return Side::Across;
+        }
+    }
+
+    /// Returns a string representation of the supplied amount of time (e.g., `12.3 ns`).
+    std::string describe_nanoseconds(double nanoseconds) {
+        std::pair<double, const char*> display{nanoseconds, " ns"};
+        if (std::abs(nanoseconds) >= 1'000'000'000.0) {
+            display = {nanoseconds / 1'000'000'000.0, " s"};
+        } else if (std::abs(nanoseconds) >= 1'000'000.0) {
+            display = {nanoseconds / 1'000'000.0, " ms"};
+        } else if (std::abs(nanoseconds) >= 1'000.0) {
+            display = {nanoseconds / 1'000.0, " µs"};
+        }
+
+        std::stringstream ss;
+        ss << std::setprecision(4) << display.first << display.second;
+        return ss.str();
+    }
+
+    void add_time(Failure& failure, const char* key, const Measurement& measurement) {
+        auto ols = measurement.get_ols();
+        failure.add_information(key, describe_nanoseconds(ols.b1.count()) + " [" +
+            describe_nanoseconds(ols.get_lower().count()) + ", " +
+            describe_nanoseconds(ols.get_upper().count()) + "]");
+    }
+
+    std::string describe_ratio(double ratio) {
+        std::stringstream ss;
+        ss << std::setprecision(4) << ratio << "×";
+        return ss.str();
+    }
+
+    void add_ratio(Failure& failure, const char* key, const Speedup& speedup) {
+        failure.add_information(key, describe_ratio(speedup.ratio) + " [" +
+            describe_ratio(speedup.lower) + ", " + describe_ratio(speedup.upper) + "]");
+    }
+}
+
+}
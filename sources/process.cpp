@@ -0,0 +1,369 @@
+// Copyright 2017 Kyle Mayes
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <accelerando/process.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+
+#if !defined(_WIN32)
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace accel {
+
+/// The job index which instructs a worker process to exit.
+constexpr static uint64_t EXIT = UINT64_MAX;
+
+#if defined(__linux__)
+/// Returns the first line of the supplied file or an empty string if it could not be read.
+std::string read_line(const std::string& path) {
+    std::ifstream file{path};
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+std::vector<int> get_isolated_cpus(Pinning pinning) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+        return {};
+    }
+
+    // Group the CPUs this process may run on by the resource they share at the supplied
+    // granularity and keep the first CPU in each group.
+    std::map<std::string, int> groups;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (!CPU_ISSET(cpu, &set)) {
+            continue;
+        }
+
+        auto directory = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+        auto package = read_line(directory + "/topology/physical_package_id");
+        std::string key;
+        switch (pinning) {
+        case Pinning::Cpu:
+            key = std::to_string(cpu);
+            break;
+        case Pinning::Core:
+            key = package + ":" + read_line(directory + "/topology/core_id");
+            break;
+        case Pinning::Cache:
+            key = read_line(directory + "/cache/index3/shared_cpu_list");
+            key = key.empty() ? package : key;
+            break;
+        }
+        groups.emplace(key, cpu);
+    }
+
+    std::vector<int> cpus;
+    for (const auto& group : groups) {
+        cpus.push_back(group.second);
+    }
+    std::sort(cpus.begin(), cpus.end());
+    return cpus;
+}
+
+bool pin_to_cpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+#else
+std::vector<int> get_isolated_cpus(Pinning) {
+    return {};
+}
+
+bool pin_to_cpu(int) {
+    return false;
+}
+#endif
+
+#if defined(_WIN32)
+bool workers_supported() {
+    return false;
+}
+
+Pool::Pool(size_t, std::vector<int>, Handler handler, Finish finish)
+    : handler{std::move(handler)}, finish{std::move(finish)} { }
+
+Pool::~Pool() { }
+
+void Pool::run(const std::vector<uint64_t>& jobs, const Done& done, const Timeout&) {
+    for (size_t index = 0; index < jobs.size() && !cancelled; ++index) {
+        done(jobs[index], {}, 0);
+    }
+}
+#else
+bool workers_supported() {
+    return true;
+}
+
+/// Writes the entirety of the supplied buffer to the supplied file descriptor.
+bool write_all(int descriptor, const char* data, size_t size) {
+    while (size != 0) {
+        auto written = ::write(descriptor, data, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        } else if (written <= 0) {
+            return false;
+        }
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+/// Reads the entirety of the supplied buffer from the supplied file descriptor.
+bool read_all(int descriptor, char* data, size_t size) {
+    while (size != 0) {
+        auto read = ::read(descriptor, data, size);
+        if (read < 0 && errno == EINTR) {
+            continue;
+        } else if (read <= 0) {
+            return false;
+        }
+        data += read;
+        size -= read;
+    }
+    return true;
+}
+
+/// Writes a length-prefixed message to the supplied file descriptor.
+bool write_message(int descriptor, const std::string& message) {
+    uint64_t size = message.size();
+    return write_all(descriptor, reinterpret_cast<const char*>(&size), sizeof(size)) &&
+        write_all(descriptor, message.data(), message.size());
+}
+
+/// Reads a length-prefixed message from the supplied file descriptor.
+std::optional<std::string> read_message(int descriptor) {
+    uint64_t size;
+    if (!read_all(descriptor, reinterpret_cast<char*>(&size), sizeof(size))) {
+        return {};
+    }
+    std::string message(size, '\0');
+    if (!read_all(descriptor, message.data(), size)) {
+        return {};
+    }
+    return message;
+}
+
+Pool::Pool(size_t count, std::vector<int> cpus, Handler handler, Finish finish)
+    : handler{std::move(handler)}, finish{std::move(finish)} {
+    // Failed writes to exited workers are detected and handled by the pool.
+    signal(SIGPIPE, SIG_IGN);
+
+    workers.resize(cpus.empty() ? count : std::min(count, cpus.size()));
+    for (size_t index = 0; index < workers.size(); ++index) {
+        workers[index].cpu = cpus.empty() ? -1 : cpus[index];
+        spawn(workers[index]);
+    }
+}
+
+Pool::~Pool() {
+    for (auto& worker : workers) {
+        shutdown(worker);
+    }
+}
+
+bool Pool::spawn(Worker& worker) {
+    int input[2], output[2];
+    if (pipe(input) != 0) {
+        return false;
+    } else if (pipe(output) != 0) {
+        close(input[0]);
+        close(input[1]);
+        return false;
+    }
+
+    // Flush any buffered output so it is not written again by the worker.
+    std::cout.flush();
+    std::fflush(stdout);
+
+    auto pid = fork();
+    if (pid == 0) {
+        // Close the pipes of the other workers so that they observe the closure of their pipes.
+        for (const auto& other : workers) {
+            if (&other != &worker && other.pid > 0) {
+                close(other.input);
+                close(other.output);
+            }
+        }
+        close(input[1]);
+        close(output[0]);
+
+        if (worker.cpu >= 0) {
+            pin_to_cpu(worker.cpu);
+        }
+
+        while (auto message = read_message(input[0])) {
+            Decoder decoder{*message};
+            auto job = decoder.read<uint64_t>();
+            if (!decoder.is_valid() || job == EXIT || !write_message(output[1], handler(job))) {
+                break;
+            }
+        }
+
+        if (finish) {
+            finish();
+        }
+        std::cout.flush();
+        std::fflush(stdout);
+        _exit(0);
+    }
+
+    close(input[0]);
+    close(output[1]);
+    if (pid < 0) {
+        close(input[1]);
+        close(output[0]);
+        return false;
+    }
+
+    worker.pid = pid;
+    worker.input = input[1];
+    worker.output = output[0];
+    worker.job = {};
+    return true;
+}
+
+void Pool::shutdown(Worker& worker) {
+    if (worker.pid <= 0) {
+        return;
+    }
+
+    write_message(worker.input, Encoder{}.write(EXIT).get());
+    reap(worker);
+}
+
+int Pool::reap(Worker& worker) {
+    close(worker.input);
+    close(worker.output);
+
+    int status = 0;
+    while (waitpid(worker.pid, &status, 0) < 0 && errno == EINTR) { }
+    worker.pid = -1;
+    return WIFSIGNALED(status) ? WTERMSIG(status) : 0;
+}
+
+void Pool::run(const std::vector<uint64_t>& jobs, const Done& done, const Timeout& timeout) {
+    using Clock = std::chrono::steady_clock;
+
+    std::deque<uint64_t> queue{jobs.begin(), jobs.end()};
+
+    auto dispatch = [&](Worker& worker) {
+        while (!worker.job && !queue.empty()) {
+            auto job = queue.front();
+            if (worker.pid <= 0 && !spawn(worker)) {
+                return;
+            }
+            queue.pop_front();
+            if (write_message(worker.input, Encoder{}.write(job).get())) {
+                worker.job = job;
+                worker.deadline = {};
+                if (auto seconds = timeout ? timeout(job) : 0.0; seconds > 0.0) {
+                    auto duration = std::chrono::duration<double>{seconds};
+                    worker.deadline = Clock::now() +
+                        std::chrono::duration_cast<Clock::duration>(duration);
+                }
+            } else {
+                done(job, {}, reap(worker));
+            }
+        }
+    };
+
+    while (true) {
+        if (cancelled) {
+            queue.clear();
+        }
+
+        std::vector<pollfd> descriptors;
+        std::vector<Worker*> busy;
+        std::optional<Clock::time_point> earliest;
+        for (auto& worker : workers) {
+            dispatch(worker);
+            if (worker.job) {
+                descriptors.push_back({worker.output, POLLIN, 0});
+                busy.push_back(&worker);
+                if (worker.deadline && (!earliest || *worker.deadline < *earliest)) {
+                    earliest = worker.deadline;
+                }
+            }
+        }
+
+        if (busy.empty()) {
+            // Report any jobs which could not be dispatched because no worker could be spawned.
+            for (auto job : queue) {
+                done(job, {}, 0);
+            }
+            return;
+        }
+
+        int milliseconds = -1;
+        if (earliest) {
+            auto remaining = *earliest - Clock::now();
+            auto rounded = std::chrono::ceil<std::chrono::milliseconds>(remaining).count();
+            milliseconds = static_cast<int>(std::max<decltype(rounded)>(0, rounded));
+        }
+        if (poll(descriptors.data(), descriptors.size(), milliseconds) < 0) {
+            continue;
+        }
+
+        for (size_t index = 0; index < busy.size(); ++index) {
+            auto& worker = *busy[index];
+            if (descriptors[index].revents == 0) {
+                // Kill the worker if its job has exceeded its timeout.
+                if (worker.deadline && Clock::now() >= *worker.deadline) {
+                    auto job = *worker.job;
+                    worker.job = {};
+                    kill(worker.pid, SIGKILL);
+                    reap(worker);
+                    done(job, {}, TIMEOUT);
+                }
+                continue;
+            }
+
+            auto job = *worker.job;
+            worker.job = {};
+            if (auto message = read_message(worker.output)) {
+                done(job, std::move(message), 0);
+            } else {
+                auto signal = reap(worker);
+                done(job, {}, signal);
+            }
+        }
+    }
+}
+#endif
+
+void Pool::cancel() {
+    cancelled = true;
+}
+
+}
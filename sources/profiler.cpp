@@ -0,0 +1,225 @@
+// Copyright 2017 Kyle Mayes
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <accelerando/profiler.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+#if !defined(_WIN32)
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <signal.h>
+#include <sys/time.h>
+#endif
+
+namespace accel {
+
+/// The number of records in the ring buffer shared with the signal handler.
+constexpr static uint64_t CAPACITY = 1024;
+
+/// The number of innermost frames belonging to the signal handler and the signal trampoline.
+constexpr static size_t SKIP = 2;
+
+/// The state shared between a started profiler and the signal handler.
+struct Shared {
+    std::atomic<Profiler::Record*> records{nullptr};
+    std::atomic<bool> active{false};
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> tail{0};
+    std::atomic<uint64_t> dropped{0};
+};
+
+static Shared SHARED;
+
+#if !defined(_WIN32)
+void handle_sigprof(int) {
+    auto records = SHARED.records.load(std::memory_order_acquire);
+    if (!records || !SHARED.active.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    // The signal may be delivered to several threads at once, so a record is reserved with a
+    // compare-and-swap and marked ready once it has been written.
+    auto head = SHARED.head.load(std::memory_order_relaxed);
+    do {
+        if (head - SHARED.tail.load(std::memory_order_acquire) >= CAPACITY) {
+            SHARED.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    } while (!SHARED.head.compare_exchange_weak(head, head + 1, std::memory_order_relaxed));
+
+    auto& record = records[head % CAPACITY];
+    auto depth = ::backtrace(record.frames, static_cast<int>(Profiler::DEPTH));
+    record.depth = depth > 0 ? static_cast<size_t>(depth) : 0;
+    record.ready.store(head + 1, std::memory_order_release);
+}
+
+std::string symbolize(void* address) {
+    Dl_info info;
+    if (::dladdr(address, &info) && info.dli_sname) {
+        int status;
+        auto demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        std::string name{status == 0 ? demangled : info.dli_sname};
+        std::free(demangled);
+        return name;
+    }
+
+    char buffer[32];
+    if (::dladdr(address, &info) && info.dli_fname) {
+        std::string module{info.dli_fname};
+        module = module.substr(module.find_last_of('/') + 1);
+        auto offset = static_cast<char*>(address) - static_cast<char*>(info.dli_fbase);
+        std::snprintf(buffer, sizeof(buffer), "+0x%tx", offset);
+        return module + buffer;
+    }
+
+    std::snprintf(buffer, sizeof(buffer), "%p", address);
+    return buffer;
+}
+#endif
+
+Profiler::Profiler(Nanoseconds<uint64_t> interval)
+    : interval{interval}, records{new Record[CAPACITY]} { }
+
+Profiler::~Profiler() {
+    stop();
+}
+
+bool Profiler::supported() {
+#if defined(_WIN32)
+    return false;
+#else
+    return true;
+#endif
+}
+
+bool Profiler::start() {
+#if defined(_WIN32)
+    return false;
+#else
+    Profiler::Record* expected = nullptr;
+    if (started || !SHARED.records.compare_exchange_strong(expected, records.get())) {
+        return started;
+    }
+
+    // Unwind once outside of the signal handler since the first call to `backtrace` may load the
+    // unwinder which is not async-signal-safe.
+    void* frames[1];
+    ::backtrace(frames, 1);
+
+    for (uint64_t index = 0; index < CAPACITY; ++index) {
+        records[index].ready.store(0, std::memory_order_relaxed);
+    }
+    SHARED.head = 0;
+    SHARED.tail = 0;
+    SHARED.dropped = 0;
+
+    struct sigaction action = {};
+    action.sa_handler = handle_sigprof;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGPROF, &action, nullptr);
+
+    auto microseconds = std::max<uint64_t>(1, interval.count() / 1000);
+    itimerval timer = {};
+    timer.it_interval.tv_sec = microseconds / 1'000'000;
+    timer.it_interval.tv_usec = microseconds % 1'000'000;
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+        SHARED.records = nullptr;
+        return false;
+    }
+
+    started = true;
+    return true;
+#endif
+}
+
+void Profiler::stop() {
+#if !defined(_WIN32)
+    if (!started) {
+        return;
+    }
+
+    itimerval timer = {};
+    setitimer(ITIMER_PROF, &timer, nullptr);
+    pause();
+    signal(SIGPROF, SIG_IGN);
+    SHARED.records = nullptr;
+    started = false;
+#endif
+}
+
+void Profiler::resume() {
+    SHARED.active.store(true, std::memory_order_relaxed);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+void Profiler::pause() {
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    SHARED.active.store(false, std::memory_order_relaxed);
+
+    if (!started) {
+        return;
+    }
+
+    // Records which are still being written by a handler on another thread are left for the next
+    // pause.
+    auto head = SHARED.head.load(std::memory_order_relaxed);
+    auto tail = SHARED.tail.load(std::memory_order_relaxed);
+    for (; tail != head; ++tail) {
+        auto& record = records[tail % CAPACITY];
+        if (record.ready.load(std::memory_order_acquire) != tail + 1) {
+            break;
+        }
+        if (record.depth > SKIP) {
+            stacks[{record.frames + SKIP, record.frames + record.depth}] += 1;
+        }
+        record.ready.store(0, std::memory_order_relaxed);
+    }
+    SHARED.tail.store(tail, std::memory_order_release);
+}
+
+uint64_t Profiler::get_dropped() const {
+    return SHARED.dropped.load(std::memory_order_relaxed);
+}
+
+std::map<std::string, uint64_t> Profiler::collect() {
+    std::map<std::string, uint64_t> folded;
+#if !defined(_WIN32)
+    std::map<void*, std::string> symbols;
+    for (const auto& [frames, count] : stacks) {
+        std::string stack;
+        for (auto iterator = frames.rbegin(); iterator != frames.rend(); ++iterator) {
+            auto symbol = symbols.find(*iterator);
+            if (symbol == symbols.end()) {
+                symbol = symbols.emplace(*iterator, symbolize(*iterator)).first;
+            }
+            if (!stack.empty()) {
+                stack.push_back(';');
+            }
+            stack.append(symbol->second);
+        }
+        folded[stack] += count;
+    }
+#endif
+    stacks.clear();
+    return folded;
+}
+
+}
@@ -0,0 +1,66 @@
+// Copyright 2017 Kyle Mayes
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <accelerando/property.hpp>
+
+#include <atomic>
+#include <thread>
+
+namespace accel {
+
+PropertyConfig& get_property_config() {
+    static PropertyConfig config;
+    return config;
+}
+
+namespace detail {
+    /// The number of consecutive cases searched by a thread at a time.
+    constexpr static uint64_t CHUNK = 4096;
+
+    uint64_t search_cases(
+        uint64_t cases, uint64_t threads, const std::function<uint64_t(uint64_t, uint64_t)>& search
+    ) {
+        if (threads == 0) {
+            threads = std::max<uint64_t>(1, std::thread::hardware_concurrency());
+        }
+        threads = std::max<uint64_t>(1, std::min(threads, (cases + CHUNK - 1) / CHUNK));
+
+        std::atomic<uint64_t> next{0};
+        std::atomic<uint64_t> failing{UINT64_MAX};
+        auto work = [&] {
+            while (true) {
+                auto start = next.fetch_add(CHUNK, std::memory_order_relaxed);
+                if (start >= cases || start >= failing.load(std::memory_order_relaxed)) {
+                    return;
+                }
+
+                auto index = search(start, std::min(cases, start + CHUNK));
+                auto first = failing.load(std::memory_order_relaxed);
+                while (index < first && !failing.compare_exchange_weak(first, index)) { }
+            }
+        };
+
+        std::vector<std::thread> helpers;
+        for (uint64_t index = 1; index < threads; ++index) {
+            helpers.emplace_back(work);
+        }
+        work();
+        for (auto& helper : helpers) {
+            helper.join();
+        }
+        return failing.load();
+    }
+}
+
+}
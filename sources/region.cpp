@@ -0,0 +1,131 @@
+// Copyright 2017 Kyle Mayes
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <accelerando/region.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+namespace accel {
+
+RegionReport::RegionReport(std::string name, Nanoseconds<double> time, double calls)
+    : name{std::move(name)}, time{time}, calls{calls} { }
+
+/// The regions and the region slots of the threads which have entered a region.
+struct Regions {
+    std::mutex mutex;
+    std::vector<std::string> names;
+    std::vector<detail::RegionSlot*> threads;
+    /// The time and number of calls accumulated by threads which have exited.
+    uint64_t retired_ticks[MAX_REGIONS] = {};
+    uint64_t retired_calls[MAX_REGIONS] = {};
+    /// The clock and timestamp counter values at the last reset.
+    std::chrono::steady_clock::time_point time;
+    uint64_t ticks = 0;
+
+    static Regions& get() {
+        static Regions regions;
+        return regions;
+    }
+};
+
+/// Unregisters the region slots of a thread and retains its accumulated time when it exits.
+struct RegionRetirer {
+    ~RegionRetirer() {
+        auto& regions = Regions::get();
+        std::lock_guard<std::mutex> lock{regions.mutex};
+        for (size_t index = 0; index < MAX_REGIONS; ++index) {
+            const auto& slot = detail::REGION_SLOTS[index];
+            regions.retired_ticks[index] += slot.ticks.load(std::memory_order_relaxed);
+            regions.retired_calls[index] += slot.calls.load(std::memory_order_relaxed);
+        }
+        auto& threads = regions.threads;
+        auto end = std::remove(threads.begin(), threads.end(), detail::REGION_SLOTS);
+        threads.erase(end, threads.end());
+    }
+};
+
+size_t Region::get_id(const char* name) {
+    auto& regions = Regions::get();
+    std::lock_guard<std::mutex> lock{regions.mutex};
+    auto& names = regions.names;
+    auto iterator = std::find(names.begin(), names.end(), name);
+    if (iterator != names.end()) {
+        return iterator - names.begin();
+    } else if (names.size() < MAX_REGIONS - 1) {
+        names.emplace_back(name);
+        return names.size() - 1;
+    } else {
+        return MAX_REGIONS - 1;
+    }
+}
+
+namespace detail {
+    void register_region_slots() {
+        thread_local RegionRetirer retirer;
+        auto& regions = Regions::get();
+        std::lock_guard<std::mutex> lock{regions.mutex};
+        regions.threads.push_back(REGION_SLOTS);
+        REGION_REGISTERED = true;
+    }
+
+    void reset_regions() {
+        auto& regions = Regions::get();
+        std::lock_guard<std::mutex> lock{regions.mutex};
+        for (auto slots : regions.threads) {
+            for (size_t index = 0; index < MAX_REGIONS; ++index) {
+                slots[index].ticks.store(0, std::memory_order_relaxed);
+                slots[index].calls.store(0, std::memory_order_relaxed);
+            }
+        }
+        std::memset(regions.retired_ticks, 0, sizeof(regions.retired_ticks));
+        std::memset(regions.retired_calls, 0, sizeof(regions.retired_calls));
+        regions.time = std::chrono::steady_clock::now();
+        regions.ticks = get_ticks();
+    }
+
+    std::vector<RegionReport> collect_regions(uint64_t iterations) {
+        auto& regions = Regions::get();
+        std::lock_guard<std::mutex> lock{regions.mutex};
+        if (regions.names.empty() || iterations == 0) {
+            return {};
+        }
+
+        // Calibrate the ticks against the monotonic clock over the period since the last reset.
+        auto elapsed = std::chrono::steady_clock::now() - regions.time;
+        auto nanoseconds = std::chrono::duration_cast<Nanoseconds<double>>(elapsed).count();
+        auto ticks = get_ticks() - regions.ticks;
+        auto scale = ticks == 0 ? 0.0 : nanoseconds / ticks;
+
+        std::vector<RegionReport> reports;
+        for (size_t index = 0; index < MAX_REGIONS; ++index) {
+            auto total_ticks = regions.retired_ticks[index];
+            auto total_calls = regions.retired_calls[index];
+            for (auto slots : regions.threads) {
+                total_ticks += slots[index].ticks.load(std::memory_order_relaxed);
+                total_calls += slots[index].calls.load(std::memory_order_relaxed);
+            }
+            if (total_calls != 0) {
+                auto name = index < regions.names.size() ? regions.names[index] : "<other>";
+                auto time = Nanoseconds<double>{(total_ticks * scale) / iterations};
+                auto calls = total_calls / static_cast<double>(iterations);
+                reports.emplace_back(std::move(name), time, calls);
+            }
+        }
+        return reports;
+    }
+}
+
+}
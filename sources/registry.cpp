@@ -14,6 +14,9 @@
 
 #include <accelerando/registry.hpp>
 
+#include <algorithm>
+#include <sstream>
+
 namespace accel {
 
 Lifecycle::Lifecycle(Function set_up, Function tear_down) : set_up{set_up}, tear_down{tear_down} { }
@@ -26,6 +29,16 @@ bool operator<(Lifecycle left, Lifecycle right) {
     }
 }
 
+bool Group::contains(const std::string& instance, const std::string& family) const {
+    if (instance == baseline) {
+        return true;
+    } else if (this->family) {
+        return family == name;
+    } else {
+        return std::find(members.begin(), members.end(), instance) != members.end();
+    }
+}
+
 Registry& Registry::get() {
     static Registry instance;
     return instance;
@@ -39,4 +52,28 @@ const std::vector<Instance<Test>>& Registry::get_tests() const {
     return tests;
 }
 
+const std::vector<const char*>& Registry::get_fuzz_targets() const {
+    return fuzz_targets;
+}
+
+int Registry::register_group(const char* name, const char* baseline, const char* members) {
+    Group group{name, baseline, {}, members == nullptr};
+    if (members) {
+        std::istringstream stream{members};
+        for (std::string member; std::getline(stream, member, ',');) {
+            member.erase(0, member.find_first_not_of(" \t\n"));
+            member.erase(member.find_last_not_of(" \t\n") + 1);
+            if (!member.empty() && member != group.baseline) {
+                group.members.push_back(member);
+            }
+        }
+    }
+    groups.push_back(std::move(group));
+    return 0;
+}
+
+const std::vector<Group>& Registry::get_groups() const {
+    return groups;
+}
+
 }
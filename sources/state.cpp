@@ -0,0 +1,126 @@
+// Copyright 2017 Kyle Mayes
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <accelerando/state.hpp>
+
+#include <accelerando/history.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+
+namespace accel {
+
+/// Adds the states in the file at the supplied path, if it exists, to the supplied states.
+static void read_states(const std::string& path, std::map<std::string, InstanceState>& instances) {
+    std::ifstream file{path};
+    for (std::string line; std::getline(file, line);) {
+        auto tab = line.find('\t');
+        if (tab == std::string::npos) {
+            continue;
+        }
+
+        InstanceState state;
+        std::istringstream fields{line.substr(0, tab)};
+        fields >> state.duration;
+        if (!fields) {
+            continue;
+        }
+
+        // Files written before outcomes were recorded only contain durations.
+        auto name = line.substr(tab + 1);
+        if (name.compare(0, 5, "pass\t") == 0 || name.compare(0, 5, "fail\t") == 0) {
+            state.failed = name[0] == 'f';
+            name = name.substr(5);
+        }
+        instances[name] = state;
+    }
+}
+
+State::State(std::string path) : path{std::move(path)} {
+    read_states(this->path, instances);
+}
+
+const InstanceState* State::find(const std::string& name) const {
+    auto iterator = instances.find(name);
+    return iterator != instances.end() ? &iterator->second : nullptr;
+}
+
+InstanceState& State::get(const std::string& name) {
+    updated.insert(name);
+    return instances[name];
+}
+
+bool State::write() const {
+    // The file may have been rewritten by another run since it was read.
+    std::map<std::string, InstanceState> merged;
+    read_states(path, merged);
+    for (const auto& name : updated) {
+        merged[name] = instances.at(name);
+    }
+
+    std::ofstream file{path};
+    for (const auto& [name, state] : merged) {
+        file << state.duration << '\t' << (state.failed ? "fail" : "pass") << '\t' << name << '\n';
+    }
+    return static_cast<bool>(file);
+}
+
+std::vector<size_t> assign_shards(
+    const std::vector<std::string>& names,
+    const std::vector<std::optional<double>>& durations,
+    size_t count
+) {
+    std::vector<size_t> shards(names.size());
+
+    double total = 0.0;
+    size_t known = 0;
+    for (const auto& duration : durations) {
+        if (duration) {
+            total += *duration;
+            known += 1;
+        }
+    }
+
+    if (known == 0) {
+        for (size_t index = 0; index < names.size(); ++index) {
+            shards[index] = hash_string(names[index]) % count;
+        }
+        return shards;
+    }
+
+    // Assign the longest instances first, breaking ties by name so the order is deterministic.
+    auto mean = total / known;
+    auto duration = [&](size_t index) { return durations[index].value_or(mean); };
+    std::vector<size_t> order(names.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t left, size_t right) {
+        if (duration(left) != duration(right)) {
+            return duration(left) > duration(right);
+        } else {
+            return names[left] < names[right];
+        }
+    });
+
+    std::vector<double> loads(count, 0.0);
+    for (auto index : order) {
+        auto shard = std::min_element(loads.begin(), loads.end()) - loads.begin();
+        shards[index] = shard;
+        loads[shard] += duration(index);
+    }
+    return shards;
+}
+
+}
@@ -0,0 +1,203 @@
+// Copyright 2017 Kyle Mayes
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <accelerando/statistics.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace accel {
+
+/// The critical value of the standard normal distribution for a 95% confidence interval.
+constexpr static double Z = 1.959964;
+
+Sample::Sample(uint64_t iterations, Nanoseconds<uint64_t> duration)
+    : iterations{iterations}
+    , duration{duration}
+    , average{duration.count() / static_cast<double>(iterations)} { }
+
+void Moments::add(double value) {
+    count += 1;
+    auto delta = value - mean;
+    mean += delta / count;
+    m2 += delta * (value - mean);
+}
+
+void Moments::merge(const Moments& other) {
+    if (other.count == 0) {
+        return;
+    }
+
+    auto total = static_cast<double>(count + other.count);
+    auto delta = other.mean - mean;
+    mean += delta * (other.count / total);
+    m2 += other.m2 + (delta * delta * ((count * static_cast<double>(other.count)) / total));
+    count += other.count;
+}
+
+double Moments::variance() const {
+    return count == 0 ? 0.0 : m2 / count;
+}
+
+double Moments::stddev() const {
+    return std::sqrt(variance());
+}
+
+void Regression::add(double x, double y) {
+    count += 1;
+    auto dx = x - xbar;
+    auto dy = y - ybar;
+    xbar += dx / count;
+    ybar += dy / count;
+    sxx += dx * (x - xbar);
+    sxy += dx * (y - ybar);
+    syy += dy * (y - ybar);
+}
+
+void Regression::merge(const Regression& other) {
+    if (other.count == 0) {
+        return;
+    }
+
+    auto total = static_cast<double>(count + other.count);
+    auto weight = (count * static_cast<double>(other.count)) / total;
+    auto dx = other.xbar - xbar;
+    auto dy = other.ybar - ybar;
+    xbar += dx * (other.count / total);
+    ybar += dy * (other.count / total);
+    sxx += other.sxx + (dx * dx * weight);
+    sxy += other.sxy + (dx * dy * weight);
+    syy += other.syy + (dy * dy * weight);
+    count += other.count;
+}
+
+LinearRegression::LinearRegression(const Regression& regression) {
+    // Calculate the y-intercept and the slope.
+    b1 = Nanoseconds<double>{regression.sxy / regression.sxx};
+    b0 = Nanoseconds<double>{regression.ybar - (b1.count() * regression.xbar)};
+
+    // Calculate the goodness of fit (the residual sum of squares is `syy - (sxy² / sxx)`).
+    r2 = (regression.sxy * regression.sxy) / (regression.sxx * regression.syy);
+
+    // Calculate the standard error of the slope (`sqrt(rss / (n - 2)) / sqrt(sxx)`).
+    if (regression.count > 2) {
+        auto rss = std::max(regression.syy - (regression.sxy * b1.count()), 0.0);
+        error = Nanoseconds<double>{std::sqrt(rss / (regression.count - 2) / regression.sxx)};
+    } else {
+        error = Nanoseconds<double>{std::numeric_limits<double>::infinity()};
+    }
+}
+
+/// Returns the regression sums for the supplied samples.
+Regression accumulate_regression(const std::vector<Sample>& samples) {
+    Regression regression;
+    for (auto sample : samples) {
+        regression.add(sample.iterations, sample.duration.count());
+    }
+    return regression;
+}
+
+LinearRegression::LinearRegression(const std::vector<Sample>& samples)
+    : LinearRegression{accumulate_regression(samples)} { }
+
+double LinearRegression::get_precision() const {
+    auto precision = Z * (error / b1);
+    return precision >= 0.0 ? precision : std::numeric_limits<double>::infinity();
+}
+
+Nanoseconds<double> LinearRegression::get_lower() const {
+    return b1 - (Z * error);
+}
+
+Nanoseconds<double> LinearRegression::get_upper() const {
+    return b1 + (Z * error);
+}
+
+Speedup::Speedup(const LinearRegression& baseline, const LinearRegression& benchmark) {
+    ratio = baseline.b1 / benchmark.b1;
+    auto left = baseline.error / baseline.b1;
+    auto right = benchmark.error / benchmark.b1;
+    auto margin = Z * std::sqrt((left * left) + (right * right));
+    lower = ratio * std::exp(-margin);
+    upper = ratio * std::exp(margin);
+}
+
+Reservoir::Reservoir(size_t capacity) : capacity{capacity} {
+    samples.reserve(capacity);
+}
+
+void Reservoir::add(Sample sample) {
+    seen += 1;
+    if (samples.size() < capacity) {
+        samples.push_back(sample);
+    } else if (auto index = std::uniform_int_distribution<uint64_t>{0, seen - 1}(random);
+            index < capacity) {
+        samples[index] = sample;
+    }
+}
+
+void Reservoir::merge(const Reservoir& other) {
+    if (other.seen == 0) {
+        return;
+    }
+
+    // Draw the merged samples from the two reservoirs in proportion to the number of samples each
+    // reservoir has been offered so that the merged samples remain a uniform random subset.
+    auto left = std::move(samples);
+    auto right = other.samples;
+    samples.clear();
+    samples.reserve(capacity);
+    auto lweight = seen, rweight = other.seen;
+    while (samples.size() < capacity && (!left.empty() || !right.empty())) {
+        auto total = (left.empty() ? 0 : lweight) + (right.empty() ? 0 : rweight);
+        auto choice = std::uniform_int_distribution<uint64_t>{0, total - 1}(random);
+        auto& source = !left.empty() && (right.empty() || choice < lweight) ? left : right;
+        auto index = std::uniform_int_distribution<size_t>{0, source.size() - 1}(random);
+        samples.push_back(source[index]);
+        source[index] = source.back();
+        source.pop_back();
+    }
+    seen += other.seen;
+}
+
+Statistics::Statistics(size_t capacity) : reservoir{capacity} { }
+
+void Statistics::add(Sample sample) {
+    count += 1;
+    iterations += sample.iterations;
+    duration += sample.duration;
+    averages.add(sample.average.count());
+    regression.add(sample.iterations, sample.duration.count());
+    reservoir.add(sample);
+    contaminated += sample.contaminated ? 1 : 0;
+    if (sample.frequency != 0.0) {
+        frequencies.add(sample.frequency);
+    }
+}
+
+void Statistics::merge(const Statistics& other) {
+    count += other.count;
+    iterations += other.iterations;
+    duration += other.duration;
+    averages.merge(other.averages);
+    regression.merge(other.regression);
+    reservoir.merge(other.reservoir);
+    contaminated += other.contaminated;
+    excluded += other.excluded;
+    frequencies.merge(other.frequencies);
+}
+
+}
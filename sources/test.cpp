@@ -14,40 +14,86 @@
 
 #include <accelerando/test.hpp>
 
+#include <chrono>
 #include <stdexcept>
 
 namespace accel {
 
-Location::Location(const char* file, uint64_t line) : file{file}, line{line} { }
-
 Failure::Failure(Location location, std::string assertion)
     : stack{location}, assertion{std::move(assertion)} { }
 
+Failure::Failure(Location location, const char* assertion, bool detailed)
+    : stack{location}, assertion{detailed ? assertion : ""}, detailed{detailed} { }
+
 void Failure::add_information(std::string key, std::string value) {
-    information.emplace_back(std::move(key), std::move(value));
+    if (detailed) {
+        information.emplace_back(std::move(key), std::move(value));
+    }
+}
+
+std::ostringstream& Failure::get_stream() {
+    thread_local std::ostringstream stream;
+    stream.str({});
+    stream.clear();
+    return stream;
+}
+
+Failures::Failures(uint64_t limit) : limit{limit} { }
+
+void Failures::push_back(Failure failure) {
+    if (is_accepting()) {
+        failures.push_back(std::move(failure));
+    } else {
+        suppressed += 1;
+    }
+}
+
+void Failures::append(Failures&& failures, Location location) {
+    for (auto& failure : failures.failures) {
+        failure.stack.insert(failure.stack.begin(), location);
+        push_back(std::move(failure));
+    }
+    suppressed += failures.suppressed;
 }
 
 TestReport::TestReport(std::vector<Failure> failures) : failures{std::move(failures)} { }
 
-TestReport Test::run() {
-    std::vector<Failure> failures;
+/// Returns the number of seconds elapsed since the supplied time and resets it to now.
+double lap(std::chrono::steady_clock::time_point& start) {
+    auto now = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::duration<double>{now - start}.count();
+    start = now;
+    return elapsed;
+}
+
+TestReport Test::run(uint64_t max_failures) {
+    Failures failures{max_failures};
 
+    auto start = std::chrono::steady_clock::now();
     set_up();
+    auto set_up_time = lap(start);
 #if defined(ACCEL_NO_EXCEPTIONS)
     execute(failures);
 #else
     try {
         execute(failures);
     } catch (const std::exception& e) {
-        failures.emplace_back(location, "Unexpected exception.");
-        failures.back().information.emplace_back("message", e.what());
+        Failure failure{location, "Unexpected exception."};
+        failure.add_information("message", e.what());
+        failures.push_back(failure);
     } catch (...) {
-        failures.emplace_back(location, "Unexpected exception of unknown type.");
+        failures.push_back(Failure{location, "Unexpected exception of unknown type."});
     }
 #endif
+    auto body_time = lap(start);
     tear_down();
 
-    return {std::move(failures)};
+    TestReport report{failures.take_failures()};
+    report.suppressed = failures.get_suppressed();
+    report.set_up = set_up_time;
+    report.body = body_time;
+    report.tear_down = lap(start);
+    return report;
 }
 
 }
@@ -0,0 +1,127 @@
+// Copyright 2017 Kyle Mayes
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <accelerando/threads.hpp>
+
+#include <algorithm>
+
+namespace accel {
+
+ThreadPool::ThreadPool(size_t count, const std::vector<uint64_t>& jobs, Job job)
+    : job{std::move(job)} {
+    count = std::max<size_t>(1, std::min(count, jobs.size()));
+    for (size_t index = 0; index < count; ++index) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (size_t index = 0; index < jobs.size(); ++index) {
+        queues[index % count]->jobs.push_back(jobs[index]);
+    }
+    for (size_t index = 0; index < count; ++index) {
+        threads.emplace_back([this, index] { work(index); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    wait();
+}
+
+void ThreadPool::wait() {
+    for (auto& thread : threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+void ThreadPool::work(size_t index) {
+    for (uint64_t next; take(index, next);) {
+        job(next);
+    }
+}
+
+bool ThreadPool::take(size_t index, uint64_t& next) {
+    {
+        std::lock_guard<std::mutex> lock{queues[index]->mutex};
+        if (auto& jobs = queues[index]->jobs; !jobs.empty()) {
+            next = jobs.front();
+            jobs.pop_front();
+            return true;
+        }
+    }
+
+    // No jobs are added once the pool has started, so the thread can exit once every queue has
+    // been observed to be empty.
+    for (size_t offset = 1; offset < queues.size(); ++offset) {
+        auto& victim = *queues[(index + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock{victim.mutex};
+        if (!victim.jobs.empty()) {
+            next = victim.jobs.back();
+            victim.jobs.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+Watchdog::Watchdog(Expired expired) : expired{std::move(expired)} {
+    thread = std::thread{[this] { watch(); }};
+}
+
+Watchdog::~Watchdog() {
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+    changed.notify_one();
+    thread.join();
+}
+
+void Watchdog::arm(uint64_t id, double seconds) {
+    auto duration = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>{seconds});
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        deadlines[id] = Clock::now() + duration;
+    }
+    changed.notify_one();
+}
+
+void Watchdog::disarm(uint64_t id) {
+    std::lock_guard<std::mutex> lock{mutex};
+    deadlines.erase(id);
+}
+
+void Watchdog::watch() {
+    std::unique_lock<std::mutex> lock{mutex};
+    while (!stopping) {
+        if (deadlines.empty()) {
+            changed.wait(lock);
+            continue;
+        }
+
+        auto earliest = std::min_element(deadlines.begin(), deadlines.end(),
+            [](const auto& left, const auto& right) { return left.second < right.second; });
+        if (Clock::now() < earliest->second) {
+            changed.wait_until(lock, earliest->second);
+        } else {
+            auto id = earliest->first;
+            deadlines.erase(earliest);
+            lock.unlock();
+            expired(id);
+            lock.lock();
+        }
+    }
+}
+
+}